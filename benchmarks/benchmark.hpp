@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "stm32f103xb.h"
+
+#include "utils/utility.hpp"
+#include "system/clock.hpp"
+#include "system/cycles.hpp"
+#include "system/tick.hpp"
+
+namespace bench {
+
+    using namespace hal;
+
+    ////////////////////////////////
+    // Results
+    ////////////////////////////////
+    // Each benchmark leaves its figures in gResults and stops at a breakpoint; read them with
+    //     (gdb) print bench::gResults
+    // Counts are HCLK cycles at 72 MHz, less the cost of the two counter reads.
+    struct result {
+        char const* Name;
+        uint32_t Fastest;
+        uint32_t Slowest;
+    };
+    inline result gResults[16]{};
+    inline size_t gCount = 0;
+
+    struct spread {
+        uint32_t Fastest = UINT32_MAX;
+        uint32_t Slowest = 0;
+
+        void Add(uint32_t const cycles) noexcept
+        {
+            Fastest = std::min(Fastest, cycles);
+            Slowest = std::max(Slowest, cycles);
+        }
+    };
+
+    inline void Record(char const* name, spread const& cycles) noexcept
+    {
+        if (gCount < std::size(gResults))
+            gResults[gCount++] = { name, cycles.Fastest, cycles.Slowest };
+    }
+    // Runs fn `runs` times and records its fastest and slowest cycle counts
+    template <typename tFN>
+    void Run(char const* name, tFN&& fn, uint16_t const runs = 32) noexcept
+    {
+        spread cycles;
+        for (uint16_t run = 0; run < runs; ++run)
+            cycles.Add(system::cycle_counter::Measure(fn));
+        Record(name, cycles);
+    }
+    // Halts at a breakpoint when a debugger is attached; a BKPT without one would hard fault
+    [[noreturn]] inline void Finish() noexcept
+    {
+        if (CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk)
+            __BKPT(0);
+        while (true);
+    }
+
+    ////////////////////////////////
+    // Board
+    ////////////////////////////////
+    // BluePill: 72 MHz from the 8 MHz crystal, 1 kHz tick and the DWT cycle counter running
+    struct board {
+        using clock = system::solved_clock<system::clock_request{ .HSE_Frequency = 8_MHz }>;
+
+        board() noexcept { system::cycle_counter::Enable(); }
+
+        clock Clock;
+        system::tick Tick{ clock::HCLK_Frequency };
+    };
+}
+
+// Every image runs the tick; each benchmark defines the handlers of the peripherals it uses
+extern "C" void SysTick_Handler() { hal::system::interrupt<hal::system::cortex_irq::SYSTICK>::Dispatch(); }
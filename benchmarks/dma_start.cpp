@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+
+#include "dma/dma.hpp"
+
+// dma::module::Start programs a channel with precomputed CCR words (user-037). A memory-to-memory
+// channel needs no peripheral, so the restart is timed alone; interrupts stay masked while
+// measuring, so the completion ISR runs afterwards. The reference rows replay the previous
+// sequence on the same channel: disable, read-modify-write flag clear, per-field configuration
+// and interrupt enables, then enable.
+
+using namespace hal;
+
+namespace {
+    constexpr auto CopySpec = dma::specification {
+        .Channel = dma::channel::_1,
+        .Direction = dma::direction::MemoryToMemory,
+        .Increment = dma::increment::Both,
+        .MemoryDataAlignment = dma::memory_alignment::Word,
+        .PeripheralDataAlignment = dma::peripheral_alignment::Word,
+        .Mode = dma::mode::Normal,
+        .Priority = dma::priority::High
+    };
+    using copy_dma = dma::module<CopySpec>;
+    using kernel = dma::kernel<CopySpec.Channel>;
+
+    uint32_t gSource[16]{};
+    uint32_t gDestination[16]{};
+
+    void transfer_complete() noexcept {}
+
+    void reference_start(copy_dma const& channel, uint32_t const source, uint32_t const destination, uint16_t const length) noexcept
+    {
+        kernel::State(DISABLED);
+        kernel::IFCR::CGIF.Set();
+        kernel::Configure(CopySpec.Direction, CopySpec.Increment, CopySpec.MemoryDataAlignment, CopySpec.PeripheralDataAlignment, CopySpec.Mode, CopySpec.Priority);
+        kernel::DataCounter(length);
+        kernel::SetPeripheralAddress(source);
+        kernel::SetMemoryAddress(destination);
+        kernel::template InterruptState<dma::interrupt::HalfTransfer>(channel.HalfTransfer.IsValid() ? ENABLED : DISABLED);
+        kernel::template InterruptState<dma::interrupt::TransferComplete>(channel.TransferComplete.IsValid() ? ENABLED : DISABLED);
+        kernel::template InterruptState<dma::interrupt::TransferError>(ENABLED);
+        kernel::State(ENABLED);
+    }
+}
+
+extern "C" void DMA1_Channel1_IRQHandler() { system::interrupt<system::peripheral_irq::DMA_1_CH1>::Dispatch(); }
+
+int main()
+{
+    bench::board board;
+    copy_dma channel;
+
+    auto const start = [&channel]() {
+        channel.Start(reinterpret_cast<uintptr_t>(gSource), reinterpret_cast<uintptr_t>(gDestination), std::size(gSource));
+    };
+    auto const reference = [&channel]() {
+        reference_start(channel, reinterpret_cast<uintptr_t>(gSource), reinterpret_cast<uintptr_t>(gDestination), std::size(gSource));
+    };
+    {
+        system::critical_section lock;
+        bench::Run("Start, no callbacks", start);
+        bench::Run("Reference, no callbacks", reference);
+    }
+    channel.TransferComplete = callback::Create<&transfer_complete>();
+    {
+        system::critical_section lock;
+        bench::Run("Start, TransferComplete bound", start);
+        bench::Run("Reference, TransferComplete bound", reference);
+    }
+    channel.Abort();
+    bench::Finish();
+}
@@ -0,0 +1,110 @@
+#include "benchmark.hpp"
+
+#include "exti/exti.hpp"
+
+// Latency of the shared EXTI15_10 dispatch (user-042), from the software trigger of line 15 to
+// its handler, with line 15 alone enabled and with all six lines enabled. Dispatch reads the
+// pending mask, so only the line that fired runs and the two figures should match. The reference
+// rows route the same vector through the previous dispatch, which called every enabled line and
+// left each callback to test and clear its own pending bit. Each count includes one counter read.
+
+using namespace hal;
+
+namespace {
+    template <exti::line tLINE>
+    using line = exti::module<exti::specification<tLINE>{ .Port = exti::gpio_port::B }>;
+
+    uint32_t volatile gStamp = 0;
+    bool volatile gFired = false;
+
+    void fired() noexcept
+    {
+        gStamp = system::cycle_counter::Now();
+        gFired = true;
+    }
+    void idle() noexcept {}
+
+    // Previous dispatch_to_lines, fed from its own table of lines 10..15
+    using PR = exti::registers<exti::line::_0>::pr;
+    constexpr uint8_t FIRST = 10;
+    constexpr uint8_t COUNT = 6;
+
+    bool volatile gReference = false;
+    uint8_t gEnabled = 0;
+    callback gLines[COUNT]{};
+
+    template <uint8_t tLINE, void (*tFN)() noexcept>
+    void own_line() noexcept
+    {
+        if (PR::REG.Read() & (1u << tLINE)) {
+            PR::REG.Write(1u << tLINE);
+            tFN();
+        }
+    }
+    void reference_dispatch() noexcept
+    {
+        for (uint8_t i = 0; i < COUNT; ++i) {
+            if (gEnabled & (1u << i))
+                gLines[i]();
+        }
+    }
+    template <uint8_t... tLINES>
+    void enable_reference() noexcept
+    {
+        gEnabled = 0;
+        ((gEnabled = static_cast<uint8_t>(gEnabled | (1u << (tLINES - FIRST)))), ...);
+    }
+
+    void measure(char const* name, line<exti::line::_15>& source) noexcept
+    {
+        bench::spread cycles;
+        for (uint16_t run = 0; run < 32u; ++run) {
+            gFired = false;
+            uint32_t const start = system::cycle_counter::Now();
+            source.GenerateInterrupt();
+            while (not gFired);
+            cycles.Add(gStamp - start);
+        }
+        bench::Record(name, cycles);
+    }
+}
+
+extern "C" void EXTI15_10_IRQHandler()
+{
+    if (gReference)
+        reference_dispatch();
+    else
+        system::interrupt<system::peripheral_irq::EXTI_15_10>::Dispatch();
+}
+
+int main()
+{
+    bench::board board;
+    line<exti::line::_15> source(exti::mode::Interrupt, exti::trigger::None, callback::Create<&fired>());
+
+    gLines[0] = callback::Create<&own_line<10u, &idle>>();
+    gLines[1] = callback::Create<&own_line<11u, &idle>>();
+    gLines[2] = callback::Create<&own_line<12u, &idle>>();
+    gLines[3] = callback::Create<&own_line<13u, &idle>>();
+    gLines[4] = callback::Create<&own_line<14u, &idle>>();
+    gLines[5] = callback::Create<&own_line<15u, &fired>>();
+
+    measure("EXTI15_10, one line enabled", source);
+    enable_reference<15u>();
+    gReference = true;
+    measure("Reference, one line enabled", source);
+    gReference = false;
+    {
+        line<exti::line::_10> l10(exti::mode::Interrupt, exti::trigger::None, callback::Create<&idle>());
+        line<exti::line::_11> l11(exti::mode::Interrupt, exti::trigger::None, callback::Create<&idle>());
+        line<exti::line::_12> l12(exti::mode::Interrupt, exti::trigger::None, callback::Create<&idle>());
+        line<exti::line::_13> l13(exti::mode::Interrupt, exti::trigger::None, callback::Create<&idle>());
+        line<exti::line::_14> l14(exti::mode::Interrupt, exti::trigger::None, callback::Create<&idle>());
+        measure("EXTI15_10, six lines enabled", source);
+        enable_reference<10u, 11u, 12u, 13u, 14u, 15u>();
+        gReference = true;
+        measure("Reference, six lines enabled", source);
+        gReference = false;
+    }
+    bench::Finish();
+}
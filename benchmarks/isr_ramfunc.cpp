@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+
+#include "dma/dma.hpp"
+
+// ISR cost from SRAM against flash (user-050). Built twice: isr_ramfunc as is, isr_flash with
+// HAL_NO_RAMFUNC, so dma::module::isr runs from .ramfunc in one image and from flash in the
+// other. A one-word memory-to-memory transfer raises the completion interrupt; the figures are
+// cycles from Start() to the callback and to the return into the waiting loop.
+
+using namespace hal;
+
+namespace {
+    constexpr auto CopySpec = dma::specification {
+        .Channel = dma::channel::_1,
+        .Direction = dma::direction::MemoryToMemory,
+        .Increment = dma::increment::Both,
+        .MemoryDataAlignment = dma::memory_alignment::Word,
+        .PeripheralDataAlignment = dma::peripheral_alignment::Word,
+        .Mode = dma::mode::Normal,
+        .Priority = dma::priority::VeryHigh
+    };
+    using copy_dma = dma::module<CopySpec>;
+
+    uint32_t gSource = 0;
+    uint32_t gDestination = 0;
+    uint32_t volatile gStamp = 0;
+    bool volatile gFired = false;
+
+    void transfer_complete() noexcept
+    {
+        gStamp = system::cycle_counter::Now();
+        gFired = true;
+    }
+}
+
+extern "C" void DMA1_Channel1_IRQHandler() { system::interrupt<system::peripheral_irq::DMA_1_CH1>::Dispatch(); }
+
+int main()
+{
+    bench::board board;
+    copy_dma channel;
+    channel.TransferComplete = callback::Create<&transfer_complete>();
+
+    bench::spread to_callback;
+    bench::spread round_trip;
+    for (uint16_t run = 0; run < 32u; ++run) {
+        gFired = false;
+        uint32_t const start = system::cycle_counter::Now();
+        channel.Start(reinterpret_cast<uintptr_t>(&gSource), reinterpret_cast<uintptr_t>(&gDestination), 1);
+        while (not gFired);
+        uint32_t const end = system::cycle_counter::Now();
+        to_callback.Add(gStamp - start);
+        round_trip.Add(end - start);
+    }
+#if defined(HAL_NO_RAMFUNC)
+    bench::Record("DMA ISR from flash, to callback", to_callback);
+    bench::Record("DMA ISR from flash, round trip", round_trip);
+#else
+    bench::Record("DMA ISR from SRAM, to callback", to_callback);
+    bench::Record("DMA ISR from SRAM, round trip", round_trip);
+#endif
+    bench::Finish();
+}
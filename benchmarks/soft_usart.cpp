@@ -0,0 +1,99 @@
+#include "benchmark.hpp"
+
+#include "usart/usart_soft.hpp"
+
+// Cost of the bit-banged USART (user-026): cycles spent in each timer ISR per bit, and the CPU
+// load of three instances running full duplex at 57600. Loop each instance back on the board:
+// PA0-PA1, PA2-PA3 and PA5-PA4. The per-bit figures cover the handler body; exception entry and
+// exit add about 24 cycles more. The load row holds per-mille figures, not cycles: the idle loop
+// passes lost while all three links stream a full buffer, exception overhead included.
+
+using namespace hal;
+
+namespace {
+    constexpr uint32_t TIMER_FREQUENCY = (bench::board::clock::PCLK1_Frequency == bench::board::clock::HCLK_Frequency)
+        ? bench::board::clock::PCLK1_Frequency
+        : bench::board::clock::PCLK1_Frequency * 2u;
+
+    template <tim::peripheral tTIMER, gpio::port tTX_PORT, gpio::pin tTX_PIN, gpio::port tRX_PORT, gpio::pin tRX_PIN>
+    using link = usart::soft_module<usart::soft_specification {
+        .Timer = tTIMER,
+        .TxPort = tTX_PORT,
+        .TxPin = tTX_PIN,
+        .RxPort = tRX_PORT,
+        .RxPin = tRX_PIN,
+        .Baud = { usart::transfer_speed::_57600, TIMER_FREQUENCY }
+    }>;
+    using link_a = link<tim::peripheral::TIM_2, gpio::port::A, gpio::pin::_0, gpio::port::A, gpio::pin::_1>;
+    using link_b = link<tim::peripheral::TIM_3, gpio::port::A, gpio::pin::_2, gpio::port::A, gpio::pin::_3>;
+    using link_c = link<tim::peripheral::TIM_4, gpio::port::A, gpio::pin::_5, gpio::port::A, gpio::pin::_4>;
+
+    // 5 ms of HCLK cycles: a 64-byte buffer takes 11 ms to send at 10 bits per frame
+    constexpr uint32_t WINDOW = bench::board::clock::HCLK_Frequency / 200u;
+
+    bench::spread gBitCycles[3]{};
+
+    template <system::peripheral_irq tIRQ>
+    INLINE void timed_dispatch(bench::spread& cycles) noexcept
+    {
+        uint32_t const start = system::cycle_counter::Now();
+        system::interrupt<tIRQ>::Dispatch();
+        cycles.Add(system::cycle_counter::Now() - start);
+    }
+    [[nodiscard]] uint32_t idle_passes() noexcept
+    {
+        uint32_t passes = 0;
+        uint32_t const start = system::cycle_counter::Now();
+        while (system::cycle_counter::Now() - start < WINDOW)
+            passes = passes + 1u;
+        return passes;
+    }
+    template <typename tLINK>
+    void fill(tLINK& link) noexcept
+    {
+        link.RxBuffer.clear();
+        for (uint8_t value = 0; link.TxBuffer.push(value); ++value);
+    }
+}
+
+extern "C" void TIM2_IRQHandler() { timed_dispatch<system::peripheral_irq::TIM_2>(gBitCycles[0]); }
+extern "C" void TIM3_IRQHandler() { timed_dispatch<system::peripheral_irq::TIM_3>(gBitCycles[1]); }
+extern "C" void TIM4_IRQHandler() { timed_dispatch<system::peripheral_irq::TIM_4>(gBitCycles[2]); }
+extern "C" void EXTI1_IRQHandler() { system::interrupt<system::peripheral_irq::EXTI_1>::Dispatch(); }
+extern "C" void EXTI3_IRQHandler() { system::interrupt<system::peripheral_irq::EXTI_3>::Dispatch(); }
+extern "C" void EXTI4_IRQHandler() { system::interrupt<system::peripheral_irq::EXTI_4>::Dispatch(); }
+
+int main()
+{
+    bench::board board;
+    link_a a;
+    link_b b;
+    link_c c;
+
+    uint32_t const idle = idle_passes();
+
+    fill(a);
+    fill(b);
+    fill(c);
+    a.StartReceiving();
+    b.StartReceiving();
+    c.StartReceiving();
+    for (auto& cycles : gBitCycles)
+        cycles = {};
+    a.StartTransmitting();
+    b.StartTransmitting();
+    c.StartTransmitting();
+    uint32_t const loaded = idle_passes();
+
+    while (a.IsTransmitting() or b.IsTransmitting() or c.IsTransmitting());
+    a.StopReceiving();
+    b.StopReceiving();
+    c.StopReceiving();
+
+    bench::Record("TIM2 ISR per bit, TX+RX", gBitCycles[0]);
+    bench::Record("TIM3 ISR per bit, TX+RX", gBitCycles[1]);
+    bench::Record("TIM4 ISR per bit, TX+RX", gBitCycles[2]);
+    uint32_t const load = 1000u - static_cast<uint32_t>((static_cast<uint64_t>(loaded) * 1000u) / idle);
+    bench::Record("Load, 3 x 57600 full duplex, per mille", { load, load });
+    bench::Finish();
+}
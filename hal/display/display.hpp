@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+#include "utils/utility.hpp"
+#include "system/tick.hpp"
+
+#include "gpio/gpio.hpp"
+#include "spi/spi.hpp"
+
+namespace hal::display {
+
+    struct rect {
+        uint16_t X;
+        uint16_t Y;
+        uint16_t Width;
+        uint16_t Height;
+    };
+
+    ////////////////////////////////
+    // Specification
+    ////////////////////////////////
+    struct specification {
+        gpio::port const SelectPort;
+        gpio::pin const SelectPin;
+        gpio::port const CommandPort;
+        gpio::pin const CommandPin;
+        uint16_t const Width;
+        uint16_t const Height;
+        uint16_t const TileWidth = 32;
+        uint16_t const TileHeight = 16;
+    };
+
+    ////////////////////////////////
+    // Panel
+    ////////////////////////////////
+    // ILI9341/ST7735 class controller on a 16-bit spi::module with DmaTransfers. A full RGB565 frame
+    // does not fit in RAM, so the screen is split into tiles: Invalidate() marks tiles dirty and
+    // Flush() renders each dirty tile through Render into one of two tile buffers, streaming it by
+    // DMA while the next tile is rendered into the other. Commands and parameters go out as 8-bit
+    // frames, pixels as 16-bit frames so RGB565 words need no byte swapping.
+    template <typename tSPI, specification tSPEC>
+    requires std::same_as<typename tSPI::data_type, uint16_t>
+    class panel {
+        static constexpr uint16_t TILES_X = (tSPEC.Width + tSPEC.TileWidth - 1u) / tSPEC.TileWidth;
+        static constexpr uint16_t TILES_Y = (tSPEC.Height + tSPEC.TileHeight - 1u) / tSPEC.TileHeight;
+        static constexpr uint16_t TILES = TILES_X * TILES_Y;
+        static constexpr uint16_t TILE_PIXELS = tSPEC.TileWidth * tSPEC.TileHeight;
+
+        static constexpr auto SelectPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = tSPEC.SelectPort,
+            .Pin = tSPEC.SelectPin,
+            .OutputMode = gpio::output_mode::GP_PushPull,
+            .OutputSpeed = gpio::output_speed::_50MHz
+        };
+        static constexpr auto CommandPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = tSPEC.CommandPort,
+            .Pin = tSPEC.CommandPin,
+            .OutputMode = gpio::output_mode::GP_PushPull,
+            .OutputSpeed = gpio::output_speed::_50MHz
+        };
+        using select_pin = gpio::module<SelectPinSpec>;
+        using command_pin = gpio::module<CommandPinSpec>;
+
+        enum instruction :uint8_t {
+             COLUMN_ADDRESS_SET = 0x2A
+            ,PAGE_ADDRESS_SET = 0x2B
+            ,MEMORY_WRITE = 0x2C
+        };
+
+    public:
+        static constexpr uint16_t Width = tSPEC.Width;
+        static constexpr uint16_t Height = tSPEC.Height;
+
+        using pixels = std::span<uint16_t>;
+
+        // Fills pixels (area.Width * area.Height, row-major) for the given screen area
+        delegate<void(rect const, pixels const)> Render;
+
+    public:
+        explicit panel(tSPI& spi) noexcept
+            : mSPI(spi)
+            , mSelect(gpio::pin_state::High)
+            , mCommand(gpio::pin_state::High)
+        {}
+
+        // Controller specific initialisation (sleep out, pixel format, orientation) is left to the caller.
+        void Command(uint8_t const command, std::span<uint8_t const> const parameters = {}) noexcept
+        {
+            wait_flush();
+            mSPI.FrameWidth(spi::data_width::_8bit);
+            mSelect.ResetPin();
+            write_command(command, parameters);
+            mSelect.SetPin();
+            mSPI.FrameWidth(spi::data_width::_16bit);
+        }
+        void Invalidate(rect const area) noexcept
+        {
+            if (area.Width == 0 or area.Height == 0 or area.X >= Width or area.Y >= Height) [[unlikely]]
+                return;
+
+            uint16_t const x0 = area.X / tSPEC.TileWidth;
+            uint16_t const y0 = area.Y / tSPEC.TileHeight;
+            uint16_t const x1 = (std::min<uint32_t>(area.X + area.Width, Width) - 1u) / tSPEC.TileWidth;
+            uint16_t const y1 = (std::min<uint32_t>(area.Y + area.Height, Height) - 1u) / tSPEC.TileHeight;
+            for (uint16_t ty = y0; ty <= y1; ++ty) {
+                for (uint16_t tx = x0; tx <= x1; ++tx)
+                    mark(ty * TILES_X + tx);
+            }
+        }
+        void InvalidateAll() noexcept { Invalidate({ 0, 0, Width, Height }); }
+        [[nodiscard]] bool IsDirty() const noexcept
+        {
+            for (uint32_t const word : mDirty) {
+                if (word)
+                    return true;
+            }
+            return false;
+        }
+        // Renders and streams every dirty tile; returns when the last tile has been sent.
+        status Flush() noexcept
+        {
+            if (not Render.IsValid()) [[unlikely]]
+                return status::Error;
+
+            uint8_t buffer = 0;
+            for (uint16_t tile = 0; tile != TILES; ++tile) {
+                if (not take(tile))
+                    continue;
+
+                rect const area = tile_area(tile);
+                uint16_t const count = area.Width * area.Height;
+                // Render while the previous tile is still streaming out of the other buffer
+                Render(area, pixels{ mTile[buffer], count });
+
+                if (wait_flush() != status::OK)
+                    return status::TimedOut;
+
+                set_window(area);
+                status const result = mSPI.template Transfer<tSPI::DMA>(mTile[buffer], nullptr, count);
+                if (result != status::OK) {
+                    mSelect.SetPin();
+                    return result;
+                }
+                mStreaming = true;
+                buffer ^= 1u;
+            }
+            return wait_flush();
+        }
+
+    private:
+        [[nodiscard]] static constexpr rect tile_area(uint16_t const tile) noexcept
+        {
+            uint16_t const x = (tile % TILES_X) * tSPEC.TileWidth;
+            uint16_t const y = (tile / TILES_X) * tSPEC.TileHeight;
+            return {
+                x,
+                y,
+                static_cast<uint16_t>(std::min<uint32_t>(tSPEC.TileWidth, Width - x)),
+                static_cast<uint16_t>(std::min<uint32_t>(tSPEC.TileHeight, Height - y))
+            };
+        }
+        INLINE void mark(uint16_t const tile) noexcept { mDirty[tile / 32u] |= (1ul << (tile % 32u)); }
+        INLINE bool take(uint16_t const tile) noexcept
+        {
+            uint32_t const mask = 1ul << (tile % 32u);
+            if (not (mDirty[tile / 32u] & mask))
+                return false;
+            mDirty[tile / 32u] &= ~mask;
+            return true;
+        }
+        uint16_t exchange(uint16_t value) noexcept
+        {
+            uint16_t rx = 0;
+            (void)mSPI.template Transfer<tSPI::BLOCKING>(&value, &rx, 1);
+            return rx;
+        }
+        void write_command(uint8_t const command, std::span<uint8_t const> const parameters) noexcept
+        {
+            mCommand.ResetPin();
+            (void)exchange(command);
+            mCommand.SetPin();
+            for (uint8_t const parameter : parameters)
+                (void)exchange(parameter);
+        }
+        // Leaves the panel selected in 16-bit frame mode, ready for MEMORY_WRITE pixel data
+        void set_window(rect const area) noexcept
+        {
+            uint16_t const x1 = area.X + area.Width - 1u;
+            uint16_t const y1 = area.Y + area.Height - 1u;
+            uint8_t const columns[4] = { static_cast<uint8_t>(area.X >> 8), static_cast<uint8_t>(area.X), static_cast<uint8_t>(x1 >> 8), static_cast<uint8_t>(x1) };
+            uint8_t const pages[4] = { static_cast<uint8_t>(area.Y >> 8), static_cast<uint8_t>(area.Y), static_cast<uint8_t>(y1 >> 8), static_cast<uint8_t>(y1) };
+
+            mSPI.FrameWidth(spi::data_width::_8bit);
+            mSelect.ResetPin();
+            write_command(COLUMN_ADDRESS_SET, columns);
+            write_command(PAGE_ADDRESS_SET, pages);
+            write_command(MEMORY_WRITE, {});
+            mSPI.FrameWidth(spi::data_width::_16bit);
+        }
+        status wait_flush() noexcept
+        {
+            if (not mStreaming)
+                return status::OK;
+
+            system::timer watchdog(constants::Timeout, true);
+            while (mSPI.IsBusy()) {
+                if (watchdog.IsExpired())
+                    return status::TimedOut;
+            }
+            mSelect.SetPin();
+            mStreaming = false;
+            return status::OK;
+        }
+
+    private:
+        tSPI& mSPI;
+        select_pin mSelect;
+        command_pin mCommand;
+
+        bool mStreaming = false;
+        uint32_t mDirty[(TILES + 31u) / 32u]{};
+        uint16_t mTile[2][TILE_PIXELS];
+    };
+}
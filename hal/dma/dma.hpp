@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "rcc/rcc_kernel.hpp"
 #include "utils/utility.hpp"
 
@@ -8,7 +10,7 @@
 #include "rcc/rcc.hpp"
 
 #include "dma_kernel.hpp"
-#include "utils/utility.hpp"
+#include "dma_registry.hpp"
 
 
 namespace hal::dma {
@@ -37,16 +39,35 @@ namespace hal::dma {
         mode const Mode;
         priority const Priority;
     };
+
+    namespace details {
+        // Complete CCR word for a specification, interrupt enables and EN excluded
+        template <specification tSPEC>
+        static constexpr uint32_t ControlWord =
+              (tSPEC.Direction == direction::MemoryToPeripheral ? DMA_CCR_DIR : 0u)
+            | (tSPEC.Direction == direction::MemoryToMemory ? DMA_CCR_MEM2MEM : 0u)
+            | ((EnumValue(tSPEC.Increment) & 1u) ? DMA_CCR_PINC : 0u)
+            | ((EnumValue(tSPEC.Increment) >> 1u) ? DMA_CCR_MINC : 0u)
+            | (static_cast<uint32_t>(EnumValue(tSPEC.PeripheralDataAlignment)) << DMA_CCR_PSIZE_Pos)
+            | (static_cast<uint32_t>(EnumValue(tSPEC.MemoryDataAlignment)) << DMA_CCR_MSIZE_Pos)
+            | (tSPEC.Mode == mode::Circular ? DMA_CCR_CIRC : 0u)
+            | (static_cast<uint32_t>(EnumValue(tSPEC.Priority)) << DMA_CCR_PL_Pos);
+    }
+
     template <specification tSPEC>
     class module 
         : private rcc::clock_handler<rcc::hclk::DMA_1>
-        , private system::interrupt<details::IRQn<tSPEC.Channel>>
+        , private system::interrupt_vector<details::IRQn<tSPEC.Channel>>
     {
         using kernel = dma::kernel<tSPEC.Channel>;
-        using irq = system::interrupt<details::IRQn<tSPEC.Channel>>;
+        using irq = system::interrupt_vector<details::IRQn<tSPEC.Channel>>;
         using hclk = rcc::clock_handler<rcc::hclk::DMA_1>;
+        using arbiter = dma::arbiter<tSPEC.Channel>;
+
+        static constexpr uint32_t CONTROL = details::ControlWord<tSPEC>;
 
     public:
+        static constexpr std::array DmaChannels{ tSPEC.Channel };
 
     public:
         callback TransferComplete;
@@ -54,17 +75,47 @@ namespace hal::dma {
         callback TransferError;
 
     public:
+        // A channel owned by another instance keeps its live transfer and ISR; this instance then
+        // installs its own configuration at Acquire()
         module() noexcept
             : hclk()
-            , irq(callback::template Create<module, &module::isr>(*this), 2_u8)
         {
-            kernel::ClearConfiguration();
-            kernel::Configure(tSPEC.Direction, tSPEC.Increment, tSPEC.MemoryDataAlignment, tSPEC.PeripheralDataAlignment, tSPEC.Mode, tSPEC.Priority);
+            if (arbiter::IsFree() or arbiter::IsOwner(this))
+                install();
+        }
+        ~module() noexcept
+        {
+            if (arbiter::IsOwner(this)) {
+                Release();
+                uninstall();
+            }
+            else if (arbiter::IsFree() and irq::Callback == handler()) {
+                uninstall();
+            }
+        }
+
+        // Time-shared channels: claim the channel, restore this module's configuration and ISR.
+        [[nodiscard]] bool Acquire() noexcept
+        {
+            if (arbiter::IsOwner(this))
+                return true;
+            if (not arbiter::TryAcquire(this))
+                return false;
+
+            install();
+            return true;
+        }
+        void Release() noexcept
+        {
+            if (arbiter::IsOwner(this))
+                Abort();
+            arbiter::Release(this);
         }
 
+        // Four plain stores and the flag clear; the CCR word only varies by the callbacks bound
         void Start(uint32_t const source_address, uint32_t const destination_address, uint16_t const length) noexcept
         {
-            kernel::State(DISABLED);
+            kernel::Control(CONTROL);
             kernel::template ClearFlag<flag::Global>();
             kernel::DataCounter(length);
             if constexpr (tSPEC.Direction == direction::MemoryToPeripheral) {
@@ -75,57 +126,53 @@ namespace hal::dma {
                 kernel::SetPeripheralAddress(source_address);
                 kernel::SetMemoryAddress(destination_address);
             }
-            if (HalfTransfer.IsValid())
-                kernel::template InterruptState<interrupt::HalfTransfer>(ENABLED);
-            else
-                kernel::template InterruptState<interrupt::HalfTransfer>(DISABLED);
-
-            if (TransferComplete.IsValid())
-                kernel::template InterruptState<interrupt::TransferComplete>(ENABLED);
-            else
-                kernel::template InterruptState<interrupt::TransferComplete>(DISABLED);
-
-            kernel::template InterruptState<interrupt::TransferError>(ENABLED);
-            kernel::State(ENABLED);
+            kernel::Control(CONTROL | DMA_CCR_TEIE | DMA_CCR_EN
+                | (HalfTransfer.IsValid() ? DMA_CCR_HTIE : 0u)
+                | (TransferComplete.IsValid() ? DMA_CCR_TCIE : 0u));
         }
         void Abort() const noexcept
         {
-            kernel::template InterruptState<interrupt::HalfTransfer>(DISABLED);
-            kernel::template InterruptState<interrupt::TransferComplete>(DISABLED);
-            kernel::template InterruptState<interrupt::TransferError>(DISABLED);
-            kernel::State(DISABLED);
+            kernel::Control(CONTROL);
             kernel::template ClearFlag<flag::Global>();
         }
         void DataCounter(uint16_t const length) noexcept { kernel::DataCounter(length); }
         [[nodiscard]] uint16_t DataCounter() noexcept { return kernel::DataCounter(); }
         
     private:
-        void isr() noexcept
+        [[nodiscard]] callback handler() noexcept { return callback::template Create<module, &module::isr>(*this); }
+        void install() noexcept
         {
+            kernel::Control(CONTROL);
+            irq::Callback = handler();
+            irq::SetPriority(2_u8);
+            irq::State(ENABLED);
+        }
+        static void uninstall() noexcept
+        {
+            irq::State(DISABLED);
+            irq::Callback.Clear();
+        }
+        RAMFUNC void isr() noexcept
+        {
+            uint32_t const control = kernel::Control();
             // Half transfer interrupt
-            if (kernel::template FlagState<flag::HalfTransfer>() and kernel::template InterruptState<interrupt::HalfTransfer>()) {
+            if (kernel::template FlagState<flag::HalfTransfer>() and (control & DMA_CCR_HTIE)) {
                 if constexpr (tSPEC.Mode != mode::Circular)
-                    kernel::template InterruptState<interrupt::HalfTransfer>(DISABLED);
+                    kernel::Control(control & ~DMA_CCR_HTIE);
                 kernel::template ClearFlag<flag::HalfTransfer>();
                 HalfTransfer();
             }
             // Transfer complete interrupt
-            else if (kernel::template FlagState<flag::TransferComplete>() and kernel::template InterruptState<interrupt::TransferComplete>()) {
+            else if (kernel::template FlagState<flag::TransferComplete>() and (control & DMA_CCR_TCIE)) {
                 kernel::template ClearFlag<flag::TransferComplete>();
-                if constexpr (tSPEC.Mode != mode::Circular) {
-                    kernel::template InterruptState<interrupt::TransferComplete>(DISABLED);
-                    kernel::template InterruptState<interrupt::TransferError>(DISABLED);
-                }
-                kernel::State(DISABLED);
+                if constexpr (tSPEC.Mode != mode::Circular)
+                    kernel::Control(CONTROL);
                 TransferComplete();
             }
             // Transfer error interrupt
-            else if (kernel::template FlagState<flag::TransferError>() and kernel::template InterruptState<interrupt::TransferError>()) {
+            else if (kernel::template FlagState<flag::TransferError>() and (control & DMA_CCR_TEIE)) {
                 kernel::template ClearFlag<flag::Global>();
-                kernel::template InterruptState<interrupt::HalfTransfer>(DISABLED);
-                kernel::template InterruptState<interrupt::TransferComplete>(DISABLED);
-                kernel::template InterruptState<interrupt::TransferError>(DISABLED);
-                kernel::State(DISABLED);
+                kernel::Control(CONTROL);
                 TransferError();
             }
         }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "utils/utility.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc/rcc.hpp"
+
+#include "dma.hpp"
+
+namespace hal::dma {
+
+    struct descriptor {
+        void const* Address;
+        uint16_t Length;
+    };
+
+    ////////////////////////////////
+    // Chain
+    ////////////////////////////////
+    // Software scatter/gather: the F1 controller has no linked-list mode, so the TC ISR reloads the
+    // memory address and count from the next descriptor. The CCR word is fixed at compile time,
+    // keeping the reload down to four stores. The descriptor list must stay valid until Complete.
+    template <specification tSPEC>
+    requires (tSPEC.Direction != direction::MemoryToMemory and tSPEC.Mode == mode::Normal)
+    class chain
+        : private rcc::clock_handler<rcc::hclk::DMA_1>
+        , private system::interrupt<details::IRQn<tSPEC.Channel>>
+    {
+        using kernel = dma::kernel<tSPEC.Channel>;
+        using irq = system::interrupt<details::IRQn<tSPEC.Channel>>;
+        using hclk = rcc::clock_handler<rcc::hclk::DMA_1>;
+
+        static constexpr uint32_t CONTROL = details::ControlWord<tSPEC> | DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+    public:
+        static constexpr std::array DmaChannels{ tSPEC.Channel };
+
+        callback Complete;
+        callback TransferError;
+
+    public:
+        chain() noexcept
+            : hclk()
+            , irq(irq::callback::template Create<chain, &chain::isr>(*this), 1_u8)
+        {
+            kernel::Control(0);
+        }
+        ~chain() noexcept { Abort(); }
+
+        status Start(uintptr_t const peripheral_address, std::span<descriptor const> const list) noexcept
+        {
+            if (list.empty()) [[unlikely]]
+                return status::Error;
+            if (mBusy) [[unlikely]]
+                return status::Busy;
+
+            mBusy = true;
+            mNext = list.data();
+            mEnd = list.data() + list.size();
+            kernel::Control(0);
+            kernel::template ClearFlag<flag::Global>();
+            kernel::SetPeripheralAddress(peripheral_address);
+            load();
+            return status::OK;
+        }
+        void Abort() noexcept
+        {
+            kernel::Control(0);
+            kernel::template ClearFlag<flag::Global>();
+            mBusy = false;
+        }
+        [[nodiscard]] bool IsBusy() const noexcept { return mBusy; }
+
+    private:
+        INLINE void load() noexcept
+        {
+            // Zero-length descriptors would never raise TC
+            while (mNext != mEnd and mNext->Length == 0)
+                ++mNext;
+            if (mNext == mEnd) {
+                kernel::Control(0);
+                mBusy = false;
+                Complete();
+                return;
+            }
+            kernel::Control(CONTROL);
+            kernel::SetMemoryAddress(reinterpret_cast<uintptr_t>(mNext->Address));
+            kernel::DataCounter(mNext->Length);
+            kernel::Control(CONTROL | DMA_CCR_EN);
+            ++mNext;
+        }
+        void isr() noexcept
+        {
+            bool const error = kernel::template FlagState<flag::TransferError>();
+            kernel::template ClearFlag<flag::Global>();
+            if (error) {
+                kernel::Control(0);
+                mBusy = false;
+                TransferError();
+                return;
+            }
+            load();
+        }
+
+    private:
+        bool volatile mBusy = false;
+        descriptor const* mNext = nullptr;
+        descriptor const* mEnd = nullptr;
+    };
+}
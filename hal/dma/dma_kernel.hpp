@@ -92,10 +92,13 @@ namespace hal::dma {
         static void SetProperty(mode const mode) noexcept { CCR::CIRC.Write(EnumValue(mode)); }
         static void SetProperty(priority const priority) noexcept { CCR::PL.Write(EnumValue(priority)); }
         static void Configure(cValidProperty auto... property) noexcept { (SetProperty(property), ...); }
-        static void DataCounter(uint16_t const length) noexcept { CNDTR::NDT.Write(length); }
+        static void Control(uint32_t const control) noexcept { CCR::REG.Write(control); }
+        [[nodiscard]] static uint32_t Control() noexcept { return CCR::REG.Read(); }
+        // CNDTR, CPAR and CMAR have no other fields; plain stores avoid a read-modify-write each
+        static void DataCounter(uint16_t const length) noexcept { CNDTR::REG.Write(length); }
         [[nodiscard]] static uint16_t DataCounter() noexcept { return CNDTR::NDT.Read(); }
-        static void SetPeripheralAddress(uint32_t const address) noexcept { CPAR::PA.Write(address); }
-        static void SetMemoryAddress(uint32_t const address) noexcept { CMAR::MA.Write(address); }
+        static void SetPeripheralAddress(uint32_t const address) noexcept { CPAR::REG.Write(address); }
+        static void SetMemoryAddress(uint32_t const address) noexcept { CMAR::REG.Write(address); }
         template <interrupt tIT>
         static void InterruptState(state const state) noexcept
         {
@@ -118,13 +121,14 @@ namespace hal::dma {
             else if constexpr (tFLAG == flag::TransferComplete) { return static_cast<state>(ISR::TCIF.Read()); }
             else if constexpr (tFLAG == flag::Global) { return static_cast<state>(ISR::GIF.Read()); }
         }
+        // IFCR is write-one-to-clear, so a single store clears only the requested flag
         template <flag tFLAG>
         static void ClearFlag() noexcept
         {
-            if constexpr (tFLAG == flag::TransferError) { IFCR::CTEIF.Set(); }
-            else if constexpr (tFLAG == flag::HalfTransfer) { IFCR::CHTIF.Set(); }
-            else if constexpr (tFLAG == flag::TransferComplete) { IFCR::CTCIF.Set(); }
-            else if constexpr (tFLAG == flag::Global) { IFCR::CGIF.Set(); }
+            if constexpr (tFLAG == flag::TransferError) { IFCR::REG.Write(DMA_IFCR_CTEIF1 << regs::CHANNEL_SHIFT); }
+            else if constexpr (tFLAG == flag::HalfTransfer) { IFCR::REG.Write(DMA_IFCR_CHTIF1 << regs::CHANNEL_SHIFT); }
+            else if constexpr (tFLAG == flag::TransferComplete) { IFCR::REG.Write(DMA_IFCR_CTCIF1 << regs::CHANNEL_SHIFT); }
+            else if constexpr (tFLAG == flag::Global) { IFCR::REG.Write(DMA_IFCR_CGIF1 << regs::CHANNEL_SHIFT); }
         }
         static void ClearConfiguration()
         {
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "utils/utility.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc/rcc.hpp"
+
+#include "dma.hpp"
+
+namespace hal::dma {
+
+    ////////////////////////////////
+    // Memcpy Engine
+    ////////////////////////////////
+    // Queued memory-to-memory copy and fill on one DMA channel. Each request is split into segments
+    // using the widest transfer size both addresses allow (word, half-word, byte), so unaligned heads
+    // and tails cost one extra segment instead of a byte-wide copy of the whole buffer.
+    template <channel tCHAN, size_t tQUEUE = 8, priority tPRIORITY = priority::Low>
+    requires (tQUEUE > 0 and (tQUEUE & (tQUEUE - 1)) == 0)
+    class memcpy_engine
+        : private rcc::clock_handler<rcc::hclk::DMA_1>
+        , private system::interrupt<details::IRQn<tCHAN>>
+    {
+        using kernel = dma::kernel<tCHAN>;
+        using irq = system::interrupt<details::IRQn<tCHAN>>;
+        using hclk = rcc::clock_handler<rcc::hclk::DMA_1>;
+
+        static constexpr size_t MASK = tQUEUE - 1;
+        static constexpr uint32_t CONTROL = DMA_CCR_MEM2MEM | DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_TEIE
+            | (EnumValue(tPRIORITY) << DMA_CCR_PL_Pos);
+
+        struct request {
+            uintptr_t Destination;
+            uintptr_t Source;
+            size_t Size;
+            bool Fill;
+            callback Complete;
+        };
+
+    public:
+        static constexpr std::array DmaChannels{ tCHAN };
+
+    public:
+        memcpy_engine() noexcept
+            : hclk()
+            , irq(irq::callback::template Create<memcpy_engine, &memcpy_engine::isr>(*this), 4_u8)
+        {
+            kernel::Control(0);
+        }
+        ~memcpy_engine() noexcept
+        {
+            kernel::Control(0);
+            kernel::template ClearFlag<flag::Global>();
+        }
+
+        status Copy(void* destination, void const* source, size_t const size, callback const& complete = {}) noexcept
+        {
+            return submit({ reinterpret_cast<uintptr_t>(destination), reinterpret_cast<uintptr_t>(source), size, false, complete });
+        }
+        // Sets size bytes of destination to value
+        status Fill(void* destination, uint8_t const value, size_t const size, callback const& complete = {}) noexcept
+        {
+            return submit({ reinterpret_cast<uintptr_t>(destination), value, size, true, complete });
+        }
+        [[nodiscard]] bool IsBusy() const noexcept { return mBusy; }
+        [[nodiscard]] uint32_t Errors() const noexcept { return mErrors; }
+
+    private:
+        status submit(request const& req) noexcept
+        {
+            if (req.Size == 0) [[unlikely]]
+                return status::Error;
+
+            system::critical_section lock;
+            size_t const head = mHead;
+            if (((head + 1) & MASK) == mTail) [[unlikely]]
+                return status::Busy;
+
+            mQueue[head] = req;
+            mHead = (head + 1) & MASK;
+
+            if (not mBusy) {
+                mBusy = true;
+                begin();
+            }
+            return status::OK;
+        }
+        void begin() noexcept
+        {
+            request const& req = mQueue[mTail];
+            mDestination = req.Destination;
+            mSource = req.Source;
+            mRemaining = req.Size;
+            if (req.Fill)
+                mPattern = req.Source * 0x01010101ul;
+            next_segment();
+        }
+        // Programs the channel for the widest run the current alignment allows. When both addresses
+        // share their offset within a word (or half-word), the head up to that boundary goes first
+        // so the body can run at full width
+        void next_segment() noexcept
+        {
+            request const& req = mQueue[mTail];
+            uintptr_t const source = req.Fill ? reinterpret_cast<uintptr_t>(&mPattern) : mSource;
+            uintptr_t const skew = req.Fill ? 0u : (mDestination ^ mSource);
+
+            uint8_t const widest = ((skew & 3u) == 0) ? 2u : ((skew & 1u) == 0) ? 1u : 0u;
+            size_t const head = (0u - mDestination) & ((1u << widest) - 1u);
+            size_t const span = head ? std::min<size_t>(head, mRemaining) : mRemaining;
+            uint8_t size_code = head ? ((head & 1u) ? 0u : 1u) : widest;
+            while (size_code and (span >> size_code) == 0)
+                --size_code;
+            size_t const units = std::min<size_t>(span >> size_code, 0xFFFFu);
+            size_t const bytes = units << size_code;
+
+            kernel::Control(0);
+            kernel::template ClearFlag<flag::Global>();
+            kernel::SetPeripheralAddress(source);
+            kernel::SetMemoryAddress(mDestination);
+            kernel::DataCounter(static_cast<uint16_t>(units));
+            uint32_t const control = CONTROL
+                | (req.Fill ? 0u : DMA_CCR_PINC)
+                | (static_cast<uint32_t>(size_code) << DMA_CCR_MSIZE_Pos)
+                | (static_cast<uint32_t>(size_code) << DMA_CCR_PSIZE_Pos);
+            kernel::Control(control);
+            kernel::Control(control | DMA_CCR_EN);
+
+            mDestination += bytes;
+            if (not req.Fill)
+                mSource += bytes;
+            mRemaining -= bytes;
+        }
+        void isr() noexcept
+        {
+            bool const error = kernel::template FlagState<flag::TransferError>();
+            kernel::template ClearFlag<flag::Global>();
+            if (not error and mRemaining) {
+                next_segment();
+                return;
+            }
+            kernel::Control(0);
+            if (error)
+                mErrors = mErrors + 1u;
+
+            callback const done = mQueue[mTail].Complete;
+            mTail = (mTail + 1) & MASK;
+            if (mTail != mHead)
+                begin();
+            else
+                mBusy = false;
+
+            done();
+        }
+
+    private:
+        bool volatile mBusy = false;
+        size_t volatile mHead = 0;
+        size_t volatile mTail = 0;
+        uint32_t volatile mErrors = 0;
+        request mQueue[tQUEUE]{};
+
+        uintptr_t mDestination = 0;
+        uintptr_t mSource = 0;
+        size_t mRemaining = 0;
+        uint32_t mPattern = 0;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "utils/utility.hpp"
+
+#include "dma.hpp"
+
+namespace hal::dma {
+
+    ////////////////////////////////
+    // Ping-Pong
+    ////////////////////////////////
+    // Double buffering on a circular channel: the 2*N buffer is split in halves, the half-transfer
+    // and transfer-complete interrupts hand the finished half to BufferReady, and the consumer gives
+    // it back with Release(). If the DMA wraps into the half the consumer still holds, the overrun is
+    // counted and reported through Overrun.
+    template <specification tSPEC, typename T, size_t tN>
+    requires (tSPEC.Mode == mode::Circular and tSPEC.Direction == direction::PeripheralToMemory and tN > 0 and (2 * tN) <= 0xFFFF)
+    class ping_pong {
+        static_assert(sizeof(T) == (1u << EnumValue(tSPEC.MemoryDataAlignment)), "Element type must match the memory data size");
+
+        using dma_module = dma::module<tSPEC>;
+
+        static constexpr uint8_t NONE = 0xFF;
+
+    public:
+        static constexpr std::array DmaChannels{ tSPEC.Channel };
+
+        using buffer = std::span<T const, tN>;
+
+        delegate<void(buffer const)> BufferReady;
+        callback Overrun;
+
+    public:
+        ping_pong() noexcept
+        {
+            mDMA.HalfTransfer.template Set<ping_pong, &ping_pong::first_half>(*this);
+            mDMA.TransferComplete.template Set<ping_pong, &ping_pong::second_half>(*this);
+        }
+        ~ping_pong() noexcept { Stop(); }
+
+        void Start(uintptr_t const peripheral_address) noexcept
+        {
+            mHeld = NONE;
+            mDMA.Start(peripheral_address, reinterpret_cast<uintptr_t>(mBuffer), static_cast<uint16_t>(2 * tN));
+        }
+        void Stop() noexcept { mDMA.Abort(); }
+        // Hands the half last passed to BufferReady back to the DMA
+        void Release() noexcept { mHeld = NONE; }
+        [[nodiscard]] uint32_t Overruns() const noexcept { return mOverruns; }
+
+    private:
+        void first_half() noexcept { ready(0); }
+        void second_half() noexcept { ready(1); }
+        // Half `index` is complete and the DMA is now writing the other one
+        void ready(uint8_t const index) noexcept
+        {
+            if (mHeld == (index ^ 1u)) {
+                mOverruns = mOverruns + 1u;
+                Overrun();
+            }
+            mHeld = index;
+            BufferReady(buffer{ mBuffer + (index * tN), tN });
+        }
+
+    private:
+        dma_module mDMA;
+
+        uint8_t volatile mHeld = NONE;
+        uint32_t volatile mOverruns = 0;
+        T mBuffer[2 * tN];
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+
+#include "utils/utility.hpp"
+
+#include "dma_registers.hpp"
+
+namespace hal::dma {
+
+    ////////////////////////////////
+    // Concepts
+    ////////////////////////////////
+    // Modules that own DMA channels publish them as `static constexpr std::array<dma::channel, N> DmaChannels`
+    template <typename T>
+    concept cDmaClient = requires {
+        { T::DmaChannels.size() } -> std::convertible_to<size_t>;
+        { T::DmaChannels[0] } -> std::convertible_to<channel>;
+    };
+
+    // Clients that can hand their channel over at run time (dma::module)
+    template <typename T>
+    concept cArbitrated = cDmaClient<T> and requires (T& client) {
+        { client.Acquire() } -> std::same_as<bool>;
+        client.Release();
+    };
+
+    // Marks a client whose channels are deliberately time-shared through dma::arbiter. Modules that
+    // bind a channel for their whole lifetime (memcpy_engine, chain, ping_pong) cannot be shared.
+    template <cArbitrated tCLIENT>
+    struct shared {
+        static constexpr auto DmaChannels = tCLIENT::DmaChannels;
+    };
+
+    namespace details {
+        template <typename T>
+        static constexpr bool IsShared = false;
+        template <cDmaClient T>
+        static constexpr bool IsShared<shared<T>> = true;
+
+        template <cDmaClient T>
+        consteval uint8_t ChannelMask() noexcept
+        {
+            uint8_t mask = 0;
+            for (channel const chan : T::DmaChannels)
+                mask |= static_cast<uint8_t>(1u << EnumValue(chan));
+            return mask;
+        }
+        template <cDmaClient... tCLIENTS>
+        consteval bool ClaimsConflict() noexcept
+        {
+            uint8_t exclusive = 0;
+            uint8_t shared = 0;
+            bool conflict = false;
+            ([&]() {
+                uint8_t const mask = ChannelMask<tCLIENTS>();
+                if constexpr (IsShared<tCLIENTS>) {
+                    conflict |= (mask & exclusive) != 0;
+                    shared |= mask;
+                }
+                else {
+                    conflict |= (mask & (exclusive | shared)) != 0;
+                    exclusive |= mask;
+                }
+            }(), ...);
+            return conflict;
+        }
+    }
+
+    ////////////////////////////////
+    // Registry
+    ////////////////////////////////
+    // Compile-time map of the DMA1 channels claimed by an application. Listing the modules of a
+    // design fails the build when two of them own the same channel, unless every claimant of that
+    // channel is wrapped in dma::shared<> and arbitrated at run time.
+    //
+    //     using board_dma = dma::registry<usart1, spi2, dma::shared<adc1_dma>, dma::shared<dac_dma>>;
+    template <cDmaClient... tCLIENTS>
+    struct registry {
+        static_assert(not details::ClaimsConflict<tCLIENTS...>(), "DMA channel claimed by more than one module");
+
+        static constexpr uint8_t ClaimedMask = (details::ChannelMask<tCLIENTS>() | ... | 0u);
+
+        template <channel tCHAN>
+        static constexpr bool IsClaimed = (ClaimedMask >> EnumValue(tCHAN)) & 1u;
+
+        // Lowest channel nobody claims, for channel-agnostic users such as dma::memcpy_engine
+        static constexpr channel FreeChannel = []() consteval noexcept {
+            uint8_t index = 0;
+            while (index < 7u and ((ClaimedMask >> index) & 1u))
+                ++index;
+            return static_cast<channel>(index);
+        }();
+        static constexpr bool HasFreeChannel = (ClaimedMask & 0x7Fu) != 0x7Fu;
+    };
+
+    ////////////////////////////////
+    // Arbiter
+    ////////////////////////////////
+    // Run-time ownership of a time-shared channel. The owner token is any stable address,
+    // usually the acquiring module; acquisition never blocks.
+    template <channel tCHAN>
+    class arbiter {
+    public:
+        [[nodiscard]] static bool TryAcquire(void const* const owner) noexcept
+        {
+            void const* expected = nullptr;
+            return sOwner.compare_exchange_strong(expected, owner, std::memory_order_acquire, std::memory_order_relaxed)
+                or expected == owner;
+        }
+        static void Release(void const* const owner) noexcept
+        {
+            void const* expected = owner;
+            (void)sOwner.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed);
+        }
+        [[nodiscard]] static bool IsOwner(void const* const owner) noexcept { return sOwner.load(std::memory_order_relaxed) == owner; }
+        [[nodiscard]] static bool IsFree() noexcept { return sOwner.load(std::memory_order_relaxed) == nullptr; }
+
+    private:
+        inline static std::atomic<void const*> sOwner = nullptr;
+    };
+}
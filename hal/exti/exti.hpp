@@ -27,8 +27,15 @@ namespace hal::exti {
             else { return system::peripheral_irq::USB_WAKEUP; }
         }();
 
+        // Selected by specialisation so shared_irq is never instantiated for a unique line
         template <line tLINE>
-        using irq = std::conditional_t<cSharedIRQ<tLINE>, shared_irq<IRQn<tLINE>>, system::interrupt<IRQn<tLINE>>>;
+        struct irq_type { using type = system::interrupt<IRQn<tLINE>>; };
+        template <line tLINE>
+        requires (cSharedIRQ<tLINE>)
+        struct irq_type<tLINE> { using type = shared_irq<IRQn<tLINE>>; };
+
+        template <line tLINE>
+        using irq = typename irq_type<tLINE>::type;
     }
 
     template <line tLINE>
@@ -95,7 +95,8 @@ namespace hal::exti {
         static void Configure(cValidProperty auto... setting) noexcept { ( SetProperty(setting), ... ); }
         static void GenerateSWI() noexcept { SWIER::SWIE.Set(); }
         [[nodiscard]] static bool IsPending() noexcept { return static_cast<bool>(PR::PEND.Read()); }
-        static void ClearPending() noexcept { PR::PEND.Set(); }
+        // PR is write-one-to-clear: a read-modify-write would also clear every other pending line
+        static void ClearPending() noexcept { PR::REG.Write(1u << EnumValue(tLine)); }
     };
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <bit>
 
 #include "system/interrupt.hpp"
 
@@ -36,6 +37,9 @@ namespace hal::exti {
             if constexpr (tIRQ == system::peripheral_irq::EXTI_9_5) return 5u;
             else return 6u;
         }();
+        static constexpr uint8_t FIRST = (tIRQ == system::peripheral_irq::EXTI_9_5) ? 5u : 10u;
+
+        using PR = registers<line::_0>::pr;
 
     protected:
         using callback = irq::callback;
@@ -77,13 +81,16 @@ namespace hal::exti {
         }
 
     private:
+        // One PR read and one PR write per interrupt; only lines that fired and are enabled run
         static void dispatch_to_lines() noexcept
         {
-            auto const enabled = sLineFlags.load(std::memory_order_acquire);
+            uint32_t pending = (PR::REG.Read() >> FIRST) & sLineFlags.load(std::memory_order_acquire);
+            PR::REG.Write(pending << FIRST);
 
-            for (uint8_t i = 0; i < COUNT; ++i) {
-                if (enabled & (1 << i))
-                    sLineISRs[i]();
+            while (pending) {
+                uint8_t const index = static_cast<uint8_t>(std::countr_zero(pending));
+                pending &= pending - 1u;
+                sLineISRs[index]();
             }
         }
 
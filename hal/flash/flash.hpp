@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "utils/utility.hpp"
+
+#include "flash_kernel.hpp"
+
+namespace hal::flash {
+
+    static constexpr uintptr_t BaseAddress = FLASH_BASE;
+    static constexpr uintptr_t EndAddress = FLASH_BANK1_END + 1u;
+    // Medium-density parts erase in 1 KB pages
+    static constexpr uint32_t PageSize = 1024;
+
+    ////////////////////////////////
+    // Programmer
+    ////////////////////////////////
+    // Keeps the FPEC unlocked for its lifetime. Flash is programmed a half-word at a time, only
+    // into erased (0xFFFF) cells, and erased a page at a time; every write is read back. A page
+    // erase takes 20-40 ms and a half-word ~50 us, during which flash fetches, ISRs included, stall.
+    class programmer {
+    public:
+        programmer(programmer&&) = delete;
+        programmer(programmer const&) = delete;
+        programmer& operator=(programmer&&) = delete;
+        programmer& operator=(programmer const&) = delete;
+
+        programmer() noexcept
+        {
+            kernel::Unlock();
+            kernel::ClearFlags();
+        }
+        ~programmer() noexcept { kernel::Lock(); }
+
+        status ErasePage(uintptr_t const page) noexcept
+        {
+            if (not contains(page, PageSize) or (page % PageSize) != 0) [[unlikely]]
+                return status::Error;
+            if (IsErased(page, PageSize))
+                return status::OK;
+            if (kernel::ErasePage(page) != status::OK)
+                return status::Error;
+            return IsErased(page, PageSize) ? status::OK : status::Error;
+        }
+        status Program(uintptr_t const address, uint16_t const value) noexcept
+        {
+            if (not contains(address, sizeof(uint16_t)) or (address % sizeof(uint16_t)) != 0) [[unlikely]]
+                return status::Error;
+            // Programming an erased cell with 0xFFFF changes nothing
+            if (value != 0xFFFF and kernel::ProgramHalfWord(address, value) != status::OK)
+                return status::Error;
+            return (read(address) == value) ? status::OK : status::Error;
+        }
+        status Program(uintptr_t const address, std::span<uint16_t const> const data) noexcept
+        {
+            if (not contains(address, data.size_bytes())) [[unlikely]]
+                return status::Error;
+            for (size_t i = 0; i < data.size(); ++i) {
+                if (Program(address + (i * sizeof(uint16_t)), data[i]) != status::OK)
+                    return status::Error;
+            }
+            return status::OK;
+        }
+
+        [[nodiscard]] static bool IsErased(uintptr_t const address, uint32_t const size) noexcept
+        {
+            for (uint32_t offset = 0; offset < size; offset += sizeof(uint32_t)) {
+                if (*reinterpret_cast<uint32_t const volatile*>(address + offset) != 0xFFFFFFFFu)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        [[nodiscard]] static bool contains(uintptr_t const address, size_t const size) noexcept
+        {
+            return address >= BaseAddress and address < EndAddress and size <= (EndAddress - address);
+        }
+        [[nodiscard]] static uint16_t read(uintptr_t const address) noexcept { return *reinterpret_cast<uint16_t const volatile*>(address); }
+    };
+}
@@ -6,6 +6,11 @@ namespace hal::flash {
 
     class kernel {
         using ACR = registers::acr;
+        using KEYR = registers::keyr;
+        using SR = registers::sr;
+        using CR = registers::cr;
+
+        static constexpr uint32_t ERRORS = FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
 
     public:
         static void SetLatency(uint32_t const latency) noexcept
@@ -20,5 +25,53 @@ namespace hal::flash {
         {
             ACR::PRFTBE.Write(state);
         }
+        static void HalfCycleState(state const state) noexcept
+        {
+            ACR::HLFCYA.Write(state);
+        }
+        // The FPEC stays unlocked until Lock() or the next reset
+        static void Unlock() noexcept
+        {
+            if (CR::LOCK.Read()) {
+                KEYR::REG.Write(FLASH_KEY1);
+                KEYR::REG.Write(FLASH_KEY2);
+            }
+        }
+        static void Lock() noexcept { CR::LOCK.Set(); }
+        [[nodiscard]] static bool IsLocked() noexcept { return CR::LOCK.Read(); }
+        [[nodiscard]] static bool IsBusy() noexcept { return SR::BSY.Read(); }
+        static void ClearFlags() noexcept { SR::REG.Write(FLASH_SR_EOP | ERRORS); }
+
+        // Program and erase run from SRAM and touch the registers directly, so nothing is fetched
+        // from flash while the operation holds the bus; flash-resident ISRs still stall until it ends
+        RAMFUNC static status ProgramHalfWord(uintptr_t const address, uint16_t const value) noexcept
+        {
+            FLASH->CR = FLASH->CR | FLASH_CR_PG;
+            *reinterpret_cast<uint16_t volatile*>(address) = value;
+            while (FLASH->SR & FLASH_SR_BSY);
+            FLASH->CR = FLASH->CR & ~FLASH_CR_PG;
+
+            uint32_t const flags = FLASH->SR;
+            FLASH->SR = flags & (FLASH_SR_EOP | ERRORS);
+            return (flags & ERRORS) ? status::Error : status::OK;
+        }
+        RAMFUNC static status ErasePage(uintptr_t const address) noexcept
+        {
+            FLASH->CR = FLASH->CR | FLASH_CR_PER;
+            FLASH->AR = address;
+            FLASH->CR = FLASH->CR | FLASH_CR_STRT;
+            while (FLASH->SR & FLASH_SR_BSY);
+            FLASH->CR = FLASH->CR & ~FLASH_CR_PER;
+
+            uint32_t const flags = FLASH->SR;
+            FLASH->SR = flags & (FLASH_SR_EOP | ERRORS);
+            return (flags & ERRORS) ? status::Error : status::OK;
+        }
+
+        // Wait states required at a given SYSCLK: 0 up to 24 MHz, 1 up to 48 MHz, 2 up to 72 MHz
+        static constexpr uint32_t LatencyFor(uint32_t const sysclk_frequency) noexcept
+        {
+            return (sysclk_frequency <= 24_MHz) ? 0u : (sysclk_frequency <= 48_MHz) ? 1u : 2u;
+        }
     };
 }
\ No newline at end of file
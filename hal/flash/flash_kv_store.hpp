@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+#include "include/expected.hpp"
+#include "utils/utility.hpp"
+
+#include "flash.hpp"
+
+namespace hal::flash {
+
+    ////////////////////////////////
+    // Key-Value Store Specification
+    ////////////////////////////////
+    struct kv_specification {
+        // Two distinct page-aligned pages reserved for the store, outside the linked image
+        uintptr_t const PageA;
+        uintptr_t const PageB;
+        // Keys are 0..Keys-1
+        uint16_t const Keys = 32;
+    };
+
+    ////////////////////////////////
+    // Key-Value Store
+    ////////////////////////////////
+    // EEPROM emulation over two flash pages. Each Write appends an 8-byte record (key, value,
+    // check) to the active page, so a page is erased once per ~127 writes rather than per write,
+    // and the two pages alternate to share the wear. When the active page fills, the latest value
+    // of every key moves to the other page in one transfer. Values are cached in a RAM index built
+    // at construction, so reads never touch flash and writes of an unchanged value are skipped.
+    //
+    // Power loss is tolerated at any point: a torn record fails its check and is skipped, and an
+    // interrupted transfer is resolved from the page headers at the next construction (the write
+    // that triggered it is lost). Writes block while flash is busy: ~200 us per record and up to
+    // two page erases on a transfer.
+    //
+    //     flash::kv_store<flash::kv_specification{ .PageA = 0x0800F800, .PageB = 0x0800FC00 }> settings;
+    //     settings.Write(BaudKey, 115200);
+    template <kv_specification tSPEC>
+    requires (tSPEC.PageA != tSPEC.PageB and (tSPEC.PageA % PageSize) == 0 and (tSPEC.PageB % PageSize) == 0
+        and tSPEC.PageA >= BaseAddress and tSPEC.PageA < EndAddress and tSPEC.PageB >= BaseAddress and tSPEC.PageB < EndAddress)
+    class kv_store {
+        enum page_state :uint16_t {
+             Erased = 0xFFFF
+            ,Receiving = 0xEEEE
+            ,Active = 0x0000
+        };
+        struct record {
+            uint16_t Key;
+            uint16_t Low;
+            uint16_t High;
+            uint16_t Check;
+        };
+
+        // Slot 0 of each page holds its header
+        static constexpr uint32_t SLOTS = PageSize / sizeof(record);
+        static_assert(tSPEC.Keys > 0 and tSPEC.Keys < SLOTS - 1u, "Every key must fit in one page with room to append");
+
+        // Salted CRC-16/CCITT of the record; 0xFFFF is reserved for "check not yet programmed", so a
+        // record torn anywhere before its last half-word never validates
+        [[nodiscard]] static constexpr uint16_t check(uint16_t const key, uint16_t const low, uint16_t const high) noexcept
+        {
+            uint16_t crc = 0x5AA5;
+            for (uint16_t const word : { key, low, high }) {
+                for (uint8_t shift = 16; shift != 0;) {
+                    shift = shift - 8u;
+                    crc = crc ^ static_cast<uint16_t>(((word >> shift) & 0xFFu) << 8u);
+                    for (uint8_t bit = 0; bit < 8u; ++bit)
+                        crc = static_cast<uint16_t>((crc & 0x8000u) ? ((crc << 1u) ^ 0x1021u) : (crc << 1u));
+                }
+            }
+            return (crc == 0xFFFF) ? 0x0000 : crc;
+        }
+        [[nodiscard]] static page_state state(uintptr_t const page) noexcept { return static_cast<page_state>(*reinterpret_cast<uint16_t const volatile*>(page)); }
+        [[nodiscard]] static record load(uintptr_t const page, uint32_t const slot) noexcept
+        {
+            auto const* const cells = reinterpret_cast<uint16_t const volatile*>(page + (slot * sizeof(record)));
+            return { cells[0], cells[1], cells[2], cells[3] };
+        }
+        [[nodiscard]] static constexpr uintptr_t other(uintptr_t const page) noexcept { return (page == tSPEC.PageA) ? tSPEC.PageB : tSPEC.PageA; }
+
+    public:
+        kv_store() noexcept { mReady = (mount() == status::OK); }
+
+        [[nodiscard]] bool IsReady() const noexcept { return mReady; }
+        [[nodiscard]] bool Contains(uint16_t const key) const noexcept { return key < tSPEC.Keys and present(key); }
+        [[nodiscard]] expected<uint32_t, status> Read(uint16_t const key) const noexcept
+        {
+            if (not Contains(key)) [[unlikely]]
+                return MakeUnexpected(status::Error);
+            return mValues[key];
+        }
+        status Write(uint16_t const key, uint32_t const value) noexcept
+        {
+            if (not mReady or key >= tSPEC.Keys) [[unlikely]]
+                return status::Error;
+            if (present(key) and mValues[key] == value)
+                return status::OK;
+
+            programmer flash;
+            if (mNext >= SLOTS)
+                return transfer(flash, key, value);
+
+            // A failed append still consumes its slot, which is skipped from now on
+            status const result = append(flash, mActive, mNext, key, value);
+            mNext = mNext + 1u;
+            if (result == status::OK)
+                remember(key, value);
+            return result;
+        }
+        // Records left before the next page transfer
+        [[nodiscard]] uint32_t Free() const noexcept { return SLOTS - mNext; }
+
+    private:
+        status mount() noexcept
+        {
+            page_state const a = state(tSPEC.PageA);
+            page_state const b = state(tSPEC.PageB);
+            programmer flash;
+
+            if (a == Active or b == Active) {
+                mActive = (a == Active) ? tSPEC.PageA : tSPEC.PageB;
+                // Leftover of a transfer interrupted before the old page was erased
+                if (flash.ErasePage(other(mActive)) != status::OK)
+                    return status::Error;
+            }
+            else if (a == Receiving or b == Receiving) {
+                // The copy finished and the old page was being erased
+                mActive = (a == Receiving) ? tSPEC.PageA : tSPEC.PageB;
+                if (flash.ErasePage(other(mActive)) != status::OK or flash.Program(mActive, Active) != status::OK)
+                    return status::Error;
+            }
+            else {
+                mActive = tSPEC.PageA;
+                if (flash.ErasePage(tSPEC.PageA) != status::OK or flash.ErasePage(tSPEC.PageB) != status::OK
+                    or flash.Program(mActive, Active) != status::OK)
+                    return status::Error;
+            }
+            scan();
+            return status::OK;
+        }
+        void scan() noexcept
+        {
+            mNext = SLOTS;
+            for (uint32_t slot = 1; slot < SLOTS; ++slot) {
+                record const entry = load(mActive, slot);
+                if (entry.Key == 0xFFFF and entry.Low == 0xFFFF and entry.High == 0xFFFF and entry.Check == 0xFFFF) {
+                    mNext = slot;
+                    break;
+                }
+                if (entry.Key < tSPEC.Keys and entry.Check != 0xFFFF and entry.Check == check(entry.Key, entry.Low, entry.High))
+                    remember(entry.Key, (static_cast<uint32_t>(entry.High) << 16u) | entry.Low);
+            }
+        }
+        // The check is programmed last, so a record is only valid once complete
+        static status append(programmer& flash, uintptr_t const page, uint32_t const slot, uint16_t const key, uint32_t const value) noexcept
+        {
+            uint16_t const low = static_cast<uint16_t>(value);
+            uint16_t const high = static_cast<uint16_t>(value >> 16u);
+            std::array<uint16_t, 4> const cells{ key, low, high, check(key, low, high) };
+            return flash.Program(page + (slot * sizeof(record)), cells);
+        }
+        status transfer(programmer& flash, uint16_t const key, uint32_t const value) noexcept
+        {
+            uintptr_t const target = other(mActive);
+            if (flash.ErasePage(target) != status::OK or flash.Program(target, Receiving) != status::OK)
+                return status::Error;
+
+            // The index only learns the new value once the target is active, so a failed transfer
+            // leaves it describing what is still in flash and a retry writes again
+            uint32_t slot = 1;
+            for (uint16_t k = 0; k < tSPEC.Keys; ++k) {
+                if (k == key) {
+                    if (append(flash, target, slot++, k, value) != status::OK)
+                        return status::Error;
+                }
+                else if (present(k) and append(flash, target, slot++, k, mValues[k]) != status::OK)
+                    return status::Error;
+            }
+            if (flash.ErasePage(mActive) != status::OK or flash.Program(target, Active) != status::OK)
+                return status::Error;
+
+            mActive = target;
+            mNext = slot;
+            remember(key, value);
+            return status::OK;
+        }
+        [[nodiscard]] bool present(uint16_t const key) const noexcept { return (mPresent[key / 32u] >> (key % 32u)) & 1u; }
+        void remember(uint16_t const key, uint32_t const value) noexcept
+        {
+            mValues[key] = value;
+            mPresent[key / 32u] = mPresent[key / 32u] | (1u << (key % 32u));
+        }
+
+    private:
+        bool mReady = false;
+        uintptr_t mActive = tSPEC.PageA;
+        uint32_t mNext = SLOTS;
+        uint32_t mValues[tSPEC.Keys]{};
+        uint32_t mPresent[(tSPEC.Keys + 31u) / 32u]{};
+    };
+}
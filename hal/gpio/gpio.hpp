@@ -183,6 +183,7 @@ namespace hal::gpio {
         void InterruptState(state const state) noexcept { mExti.InterruptState(state); }
         void SetCallback(callback const& func) noexcept { mExti.SetCallback(func); }
         void ClearCallback() noexcept { mExti.ClearCallback(); }
+        void ClearPending() noexcept { mExti.ClearPending(); }
     
     private:
         exti_pin mExti;
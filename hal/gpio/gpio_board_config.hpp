@@ -0,0 +1,118 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#include "utils/utility.hpp"
+
+#include "rcc/rcc.hpp"
+
+#include "gpio.hpp"
+
+namespace hal::gpio {
+
+    namespace details {
+        // CNF[1:0]:MODE[1:0] nibble of a pin specification
+        template <specification tSPEC>
+        static constexpr uint32_t ConfigNibble = []() consteval noexcept {
+            if constexpr (tSPEC.PinType == pin_type::Output)
+                return static_cast<uint32_t>((EnumValue(tSPEC.OutputMode) << 2u) | EnumValue(tSPEC.OutputSpeed));
+            else
+                return static_cast<uint32_t>((EnumValue(tSPEC.InputMode) & 0b11u) << 2u);
+        }();
+        template <specification tSPEC>
+        static constexpr auto PullMode = []() consteval noexcept {
+            if constexpr (tSPEC.PinType == pin_type::Output)
+                return input_mode::Analog;
+            else
+                return tSPEC.InputMode;
+        }();
+
+        template <port tPORT, bool tUSED>
+        struct port_clock {};
+        template <port tPORT>
+        struct port_clock<tPORT, true>
+            : private rcc::clock_handler<PCLK<tPORT>>
+        {
+            port_clock() noexcept : rcc::clock_handler<PCLK<tPORT>>() {}
+        };
+    }
+
+    ////////////////////////////////
+    // Board Configuration
+    ////////////////////////////////
+    // Folds the pin specifications of a board into one CRL word, one CRH word and one BSRR
+    // pull-up/pull-down word per port, all computed at compile time. Construction takes one clock
+    // reference per port in use, sets the pull levels, then writes each configuration register once,
+    // so every pin of a register switches mode in the same bus cycle.
+    //
+    //     static constexpr auto LED = gpio::specification<gpio::pin_type::Output>{ .Port = gpio::port::C, .Pin = gpio::pin::_13 };
+    //     static constexpr auto KEY = gpio::specification<gpio::pin_type::Input>{ .Port = gpio::port::A, .Pin = gpio::pin::_0, .InputMode = gpio::input_mode::PullUp };
+    //     gpio::board_config<LED, KEY> board;
+    //
+    // Pins configured this way are driven through gpio::port_group rather than gpio::module, whose
+    // constructor would configure the pin again. External interrupt pins are left to gpio::module,
+    // which also routes and enables their EXTI line.
+    template <specification... tSPECS>
+    requires (sizeof...(tSPECS) > 0 and ((tSPECS.PinType != pin_type::Null and tSPECS.PinType != pin_type::ExtInterrupt) and ...))
+    class board_config
+        : private details::port_clock<port::A, ((tSPECS.Port == port::A) or ...)>
+        , private details::port_clock<port::B, ((tSPECS.Port == port::B) or ...)>
+        , private details::port_clock<port::C, ((tSPECS.Port == port::C) or ...)>
+        , private details::port_clock<port::D, ((tSPECS.Port == port::D) or ...)>
+        , private details::port_clock<port::E, ((tSPECS.Port == port::E) or ...)>
+    {
+        template <port tPORT>
+        static constexpr uint16_t PinMask = (((tSPECS.Port == tPORT) ? (1u << EnumValue(tSPECS.Pin)) : 0u) | ... | 0u);
+        template <port tPORT, bool tHIGH>
+        static constexpr uint32_t CrMask = (((tSPECS.Port == tPORT and (EnumValue(tSPECS.Pin) >= 8u) == tHIGH)
+            ? (0xFu << ((EnumValue(tSPECS.Pin) % 8u) * 4u)) : 0u) | ... | 0u);
+        template <port tPORT, bool tHIGH>
+        static constexpr uint32_t CrWord = (((tSPECS.Port == tPORT and (EnumValue(tSPECS.Pin) >= 8u) == tHIGH)
+            ? (details::ConfigNibble<tSPECS> << ((EnumValue(tSPECS.Pin) % 8u) * 4u)) : 0u) | ... | 0u);
+        template <port tPORT, input_mode tPULL>
+        static constexpr uint32_t PullMask = (((tSPECS.Port == tPORT and details::PullMode<tSPECS> == tPULL)
+            ? (1u << EnumValue(tSPECS.Pin)) : 0u) | ... | 0u);
+
+        static_assert(std::popcount(PinMask<port::A>) + std::popcount(PinMask<port::B>) + std::popcount(PinMask<port::C>)
+            + std::popcount(PinMask<port::D>) + std::popcount(PinMask<port::E>) == sizeof...(tSPECS), "Pin configured more than once");
+
+        template <port tPORT>
+        static void configure_port() noexcept
+        {
+            if constexpr (PinMask<tPORT> != 0) {
+                using CRL = registers<tPORT, pin::_0>::crx;
+                using CRH = registers<tPORT, pin::_8>::crx;
+                using BSRR = registers<tPORT, pin::_0>::bsrr;
+
+                // Pull levels first, so inputs never float while their mode changes
+                constexpr uint32_t pulls = PullMask<tPORT, input_mode::PullUp> | (PullMask<tPORT, input_mode::PullDown> << 16u);
+                if constexpr (pulls != 0)
+                    BSRR::REG.Write(pulls);
+                write_cr<CRL, CrMask<tPORT, false>, CrWord<tPORT, false>>();
+                write_cr<CRH, CrMask<tPORT, true>, CrWord<tPORT, true>>();
+            }
+        }
+        template <typename tCR, uint32_t tMASK, uint32_t tWORD>
+        static void write_cr() noexcept
+        {
+            if constexpr (tMASK == 0xFFFFFFFFu)
+                tCR::REG.Write(tWORD);
+            else if constexpr (tMASK != 0)
+                tCR::REG.Write((tCR::REG.Read() & ~tMASK) | tWORD);
+        }
+
+    public:
+        board_config() noexcept
+        {
+            configure_port<port::A>();
+            configure_port<port::B>();
+            configure_port<port::C>();
+            configure_port<port::D>();
+            configure_port<port::E>();
+        }
+
+        template <port tPORT>
+        static constexpr uint16_t Pins = PinMask<tPORT>;
+    };
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "utils/utility.hpp"
+
+#include "dma/dma.hpp"
+#include "exti/exti.hpp"
+#include "tim/tim.hpp"
+
+#include "gpio.hpp"
+
+namespace hal::gpio {
+
+    enum class capture_state :uint8_t {
+         Idle
+        ,Armed
+        ,Triggered
+        ,Done
+    };
+
+    ////////////////////////////////
+    // Capture Specification
+    ////////////////////////////////
+    struct capture_specification {
+        port const Port;
+        tim::peripheral const Timer;
+        uint16_t const Prescaler = 0;
+        // Sample period in timer ticks minus one
+        uint16_t const Period;
+        uint16_t const Depth = 1024;
+        // Samples kept after the trigger; the rest of the buffer holds pre-trigger history
+        uint16_t const PostTrigger = 256;
+        // The trigger edge on TriggerPin is qualified by (IDR & TriggerMask) == TriggerPattern
+        pin const TriggerPin = pin::_0;
+        exti::trigger const TriggerEdge = exti::trigger::Rising;
+        uint16_t const TriggerMask = 0;
+        uint16_t const TriggerPattern = 0;
+    };
+
+    ////////////////////////////////
+    // Capture
+    ////////////////////////////////
+    // Logic analyser on one port: timer update events trigger DMA reads of IDR into a circular
+    // buffer, so sampling costs no CPU time. An EXTI edge on TriggerPin, qualified by a pattern on
+    // the whole port, marks the trigger; the half/complete DMA interrupts then count PostTrigger
+    // samples and stop the timer. Stopping happens at half-buffer granularity, so up to Depth/2
+    // extra samples may follow, and EXTI latency places the trigger mark a few samples late at
+    // multi-MHz rates.
+    //
+    // Export() streams the result run-length encoded over an 8-bit usart::module:
+    //     'L' 'A' <samples:u16> <trigger index:u16> then <value:u16><run:u16> records, little-endian
+    template <capture_specification tSPEC>
+    requires (tSPEC.Timer != tim::peripheral::TIM_1 and tSPEC.Depth >= 4 and (tSPEC.Depth % 2) == 0
+        and tSPEC.PostTrigger > 0 and tSPEC.PostTrigger <= tSPEC.Depth / 2)
+    class capture {
+        static constexpr auto TimerSpec = tim::specification {
+            .Peripheral = tSPEC.Timer,
+            .Prescaler = tSPEC.Prescaler,
+            .Period = tSPEC.Period
+        };
+        static constexpr auto DmaSpec = dma::specification {
+            .Channel = tim::details::UpdateDMA_Channel<tSPEC.Timer>,
+            .Direction = dma::direction::PeripheralToMemory,
+            .Increment = dma::increment::Memory,
+            .MemoryDataAlignment = dma::memory_alignment::HalfWord,
+            .PeripheralDataAlignment = dma::peripheral_alignment::HalfWord,
+            .Mode = dma::mode::Circular,
+            .Priority = dma::priority::VeryHigh
+        };
+        static constexpr auto TriggerSpec = specification<pin_type::ExtInterrupt> {
+            .Port = tSPEC.Port,
+            .Pin = tSPEC.TriggerPin,
+            .InputMode = input_mode::Floating
+        };
+
+        using timer = tim::module<TimerSpec>;
+        using dma_module = dma::module<DmaSpec>;
+        using trigger_pin = gpio::module<TriggerSpec>;
+        using kernel = gpio::kernel<tSPEC.Port, pin::_0>;
+        using IDR = registers<tSPEC.Port, pin::_0>::idr;
+
+        static constexpr uint16_t DEPTH = tSPEC.Depth;
+        static constexpr uint16_t HALF = DEPTH / 2;
+
+    public:
+        static constexpr std::array DmaChannels{ DmaSpec.Channel };
+
+        callback Captured;
+
+    public:
+        capture() noexcept
+            : mTrigger(exti::mode::Off, tSPEC.TriggerEdge, callback::template Create<capture, &capture::trigger_edge>(*this))
+        {
+            mDMA.HalfTransfer.template Set<capture, &capture::first_half>(*this);
+            mDMA.TransferComplete.template Set<capture, &capture::second_half>(*this);
+        }
+        ~capture() noexcept { Abort(); }
+
+        // Starts sampling and waits for the trigger
+        status Arm() noexcept
+        {
+            if (mState == capture_state::Armed or mState == capture_state::Triggered) [[unlikely]]
+                return status::Busy;
+
+            mState = capture_state::Armed;
+            mDMA.Start(kernel::InputDataAddress(), reinterpret_cast<uintptr_t>(mBuffer), DEPTH);
+            mTimer.Counter(0);
+            mTimer.UpdateDMA(ENABLED);
+            mTimer.Start();
+            mTrigger.ClearPending();
+            mTrigger.SetMode(exti::mode::Interrupt);
+            return status::OK;
+        }
+        // Marks the trigger now, whatever the pin state
+        void ForceTrigger() noexcept
+        {
+            system::critical_section lock;
+            if (mState == capture_state::Armed)
+                triggered();
+        }
+        void Abort() noexcept
+        {
+            mTrigger.SetMode(exti::mode::Off);
+            stop_sampling();
+            mState = capture_state::Idle;
+        }
+        [[nodiscard]] capture_state State() const noexcept { return mState; }
+        [[nodiscard]] bool IsDone() const noexcept { return mState == capture_state::Done; }
+
+        // Chronological view of a finished capture; index 0 is the oldest sample
+        [[nodiscard]] static constexpr uint16_t Size() noexcept { return DEPTH; }
+        [[nodiscard]] uint16_t TriggerIndex() const noexcept { return static_cast<uint16_t>((mTriggerPos + DEPTH - mEnd) % DEPTH); }
+        [[nodiscard]] uint16_t operator[](uint16_t const index) const noexcept { return mBuffer[(mEnd + index) % DEPTH]; }
+
+        // Blocking run-length encoded dump of a finished capture
+        template <typename tUSART>
+        requires std::same_as<typename tUSART::data_type, uint8_t>
+        status Export(tUSART& usart) noexcept
+        {
+            if (mState != capture_state::Done) [[unlikely]]
+                return status::Error;
+
+            // Records are batched into the TX FIFO and flushed whenever it fills up
+            auto put = [&usart](uint16_t const value) noexcept {
+                if (usart.TxBuffer.available() < 3 and not usart.Transmit().has_value())
+                    return false;
+                usart.TxBuffer.push(static_cast<uint8_t>(value));
+                usart.TxBuffer.push(static_cast<uint8_t>(value >> 8u));
+                return true;
+            };
+            if (not put('L' | ('A' << 8u)) or not put(DEPTH) or not put(TriggerIndex()))
+                return status::TimedOut;
+
+            uint16_t index = 0;
+            while (index < DEPTH) {
+                uint16_t const value = (*this)[index];
+                uint16_t run = 1;
+                while (index + run < DEPTH and (*this)[index + run] == value)
+                    ++run;
+                if (not put(value) or not put(run))
+                    return status::TimedOut;
+                index += run;
+            }
+            if (not usart.TxBuffer.empty() and not usart.Transmit().has_value())
+                return status::TimedOut;
+            return status::OK;
+        }
+
+    private:
+        [[nodiscard]] uint16_t position() noexcept { return static_cast<uint16_t>((DEPTH - mDMA.DataCounter()) % DEPTH); }
+        void trigger_edge() noexcept
+        {
+            mTrigger.ClearPending();
+            if (mState != capture_state::Armed)
+                return;
+            if ((IDR::REG.Read() & tSPEC.TriggerMask) == tSPEC.TriggerPattern)
+                triggered();
+        }
+        void triggered() noexcept
+        {
+            mTrigger.SetMode(exti::mode::Off);
+            mTriggerPos = position();
+            mMark = mTriggerPos;
+            mSinceTrigger = 0;
+            mState = capture_state::Triggered;
+        }
+        void first_half() noexcept { boundary(HALF); }
+        void second_half() noexcept { boundary(0); }
+        // The DMA has just crossed `at`; count the samples written since the previous mark
+        void boundary(uint16_t const at) noexcept
+        {
+            if (mState != capture_state::Triggered)
+                return;
+
+            mSinceTrigger = mSinceTrigger + ((at + DEPTH - mMark) % DEPTH);
+            mMark = at;
+            if (mSinceTrigger < tSPEC.PostTrigger)
+                return;
+
+            stop_sampling();
+            mEnd = position();
+            mState = capture_state::Done;
+            Captured();
+        }
+        void stop_sampling() noexcept
+        {
+            mTimer.Stop();
+            mTimer.UpdateDMA(DISABLED);
+            mDMA.Abort();
+        }
+
+    private:
+        timer mTimer;
+        dma_module mDMA;
+        trigger_pin mTrigger;
+
+        capture_state volatile mState = capture_state::Idle;
+        uint16_t mTriggerPos = 0;
+        uint16_t mMark = 0;
+        uint16_t mEnd = 0;
+        uint32_t volatile mSinceTrigger = 0;
+        uint16_t mBuffer[tSPEC.Depth];
+    };
+}
@@ -56,5 +56,8 @@ namespace hal::gpio {
         static void OutputPinState(pin_state const state) noexcept { ODR::OD.Write(EnumValue(state)); }
         static void AtomicSet() noexcept { BSRR::BS.Set(); }
         static void AtomicReset() noexcept { BSRR::BR.Set(); }
+        // Port-wide register addresses, for DMA streaming to and from the whole port
+        static constexpr uint32_t BitSetResetAddress() noexcept { return BSRR::REG.Address; }
+        static constexpr uint32_t InputDataAddress() noexcept { return IDR::REG.Address; }
     };
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+#include "utils/utility.hpp"
+
+#include "rcc/rcc.hpp"
+
+#include "gpio.hpp"
+
+namespace hal::gpio {
+
+    ////////////////////////////////
+    // Port Group
+    ////////////////////////////////
+    // A set of pins on one port handled as a single value: bit i of the value maps to the i-th pin
+    // of the list. Writes are one BSRR store and reads are one IDR load; when the pins are listed in
+    // ascending contiguous order the scatter/gather collapses to a shift, otherwise it is unrolled
+    // at compile time into one shift-and-mask per pin.
+    //
+    //     gpio::port_group<gpio::port::B, gpio::pin::_8, gpio::pin::_9, ..., gpio::pin::_15> lcd_data;
+    //     lcd_data.Configure(gpio::output_mode::GP_PushPull, gpio::output_speed::_50MHz);
+    //     lcd_data = 0xA5;
+    template <port tPORT, pin... tPINS>
+    requires (sizeof...(tPINS) > 0 and sizeof...(tPINS) <= 16)
+    class port_group
+        : private rcc::clock_handler<details::PCLK<tPORT>>
+    {
+        using pclk = rcc::clock_handler<details::PCLK<tPORT>>;
+        using CRL = registers<tPORT, pin::_0>::crx;
+        using CRH = registers<tPORT, pin::_8>::crx;
+        using IDR = registers<tPORT, pin::_0>::idr;
+        using ODR = registers<tPORT, pin::_0>::odr;
+        using BSRR = registers<tPORT, pin::_0>::bsrr;
+
+        static constexpr std::array<uint8_t, sizeof...(tPINS)> PINS{ EnumValue(tPINS)... };
+        static constexpr uint8_t FIRST = PINS[0];
+        static constexpr bool CONTIGUOUS = []() consteval noexcept {
+            for (size_t i = 1; i < PINS.size(); ++i)
+                if (PINS[i] != PINS[i - 1] + 1u)
+                    return false;
+            return true;
+        }();
+        // Four configuration bits per pin, split over CRL (pins 0-7) and CRH (pins 8-15)
+        static constexpr uint32_t CRL_MASK = ((EnumValue(tPINS) < 8u ? (0xFu << (EnumValue(tPINS) * 4u)) : 0u) | ...);
+        static constexpr uint32_t CRH_MASK = ((EnumValue(tPINS) >= 8u ? (0xFu << ((EnumValue(tPINS) - 8u) * 4u)) : 0u) | ...);
+
+    public:
+        static constexpr auto Port = tPORT;
+        static constexpr uint16_t Mask = ((1u << EnumValue(tPINS)) | ...);
+        static constexpr size_t Width = sizeof...(tPINS);
+
+        using value_type = std::conditional_t<(Width > 8), uint16_t, uint8_t>;
+
+        static_assert(std::popcount(Mask) == Width, "Each pin may appear only once in a port group");
+
+    public:
+        port_group() noexcept : pclk() {}
+
+        void Configure(output_mode const mode, output_speed const speed) const noexcept
+        {
+            configure(static_cast<uint32_t>((EnumValue(mode) << 2u) | EnumValue(speed)));
+        }
+        void Configure(input_mode const mode) const noexcept
+        {
+            if (mode == input_mode::PullUp)
+                BSRR::REG.Write(Mask);
+            else if (mode == input_mode::PullDown)
+                BSRR::REG.Write(static_cast<uint32_t>(Mask) << 16u);
+            configure(static_cast<uint32_t>((EnumValue(mode) & 0b11u) << 2u));
+        }
+
+        // Drives every pin of the group with a single BSRR store
+        void Write(value_type const value) const noexcept { BSRR::REG.Write(SetResetWord(value)); }
+        // Sets or clears only the pins selected by `pins`, leaving the others untouched
+        void Set(value_type const pins) const noexcept { BSRR::REG.Write(Scatter(pins)); }
+        void Reset(value_type const pins) const noexcept { BSRR::REG.Write(Scatter(pins) << 16u); }
+        [[nodiscard]] value_type Read() const noexcept { return Gather(IDR::REG.Read()); }
+        [[nodiscard]] value_type Output() const noexcept { return Gather(ODR::REG.Read()); }
+
+        port_group const& operator=(value_type const value) const noexcept
+        {
+            Write(value);
+            return *this;
+        }
+        operator value_type() const noexcept { return Read(); }
+
+        // Maps a group value onto port bit positions
+        [[nodiscard]] static constexpr uint32_t Scatter(value_type const value) noexcept
+        {
+            if constexpr (CONTIGUOUS)
+                return (static_cast<uint32_t>(value) << FIRST) & Mask;
+            else
+                return [value]<size_t... I>(std::index_sequence<I...>) noexcept {
+                    return ((((static_cast<uint32_t>(value) >> I) & 1u) << PINS[I]) | ...);
+                }(std::make_index_sequence<Width>{});
+        }
+        // BSRR word driving the group to value, e.g. for DMA tables fed to gpio::waveform
+        [[nodiscard]] static constexpr uint32_t SetResetWord(value_type const value) noexcept
+        {
+            uint32_t const bits = Scatter(value);
+            return bits | (static_cast<uint32_t>(Mask & ~bits) << 16u);
+        }
+        // Collects port bit positions back into a group value
+        [[nodiscard]] static constexpr value_type Gather(uint32_t const port_bits) noexcept
+        {
+            if constexpr (CONTIGUOUS)
+                return static_cast<value_type>((port_bits & Mask) >> FIRST);
+            else
+                return [port_bits]<size_t... I>(std::index_sequence<I...>) noexcept {
+                    return static_cast<value_type>(((((port_bits >> PINS[I]) & 1u) << I) | ...));
+                }(std::make_index_sequence<Width>{});
+        }
+
+    private:
+        // One read-modify-write per configuration register, whatever the number of pins
+        static void configure(uint32_t const nibble) noexcept
+        {
+            if constexpr (CRL_MASK != 0)
+                CRL::REG.Write((CRL::REG.Read() & ~CRL_MASK) | ((nibble * 0x11111111u) & CRL_MASK));
+            if constexpr (CRH_MASK != 0)
+                CRH::REG.Write((CRH::REG.Read() & ~CRH_MASK) | ((nibble * 0x11111111u) & CRH_MASK));
+        }
+    };
+}
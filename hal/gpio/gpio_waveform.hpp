@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "utils/utility.hpp"
+
+#include "dma/dma.hpp"
+#include "tim/tim.hpp"
+
+#include "gpio.hpp"
+
+namespace hal::gpio {
+
+    ////////////////////////////////
+    // Waveform Specification
+    ////////////////////////////////
+    struct waveform_specification {
+        port const Port;
+        tim::peripheral const Timer;
+        uint16_t const Prescaler = 0;
+        // Sample period in timer ticks minus one; the DMA moves one table entry per update event
+        uint16_t const Period;
+        bool const Loop = false;
+    };
+
+    ////////////////////////////////
+    // Waveform
+    ////////////////////////////////
+    // Plays a table of BSRR words onto one port: every timer update event requests a DMA transfer
+    // of the next word, so multi-pin patterns run at the timer rate without CPU involvement. Words
+    // are built with gpio::port_group::SetResetWord or by hand (set bits low half, reset bits high
+    // half); pins not named in a word keep their level. The pins must already be configured as
+    // outputs (gpio::board_config, gpio::port_group). With Loop the table repeats until Stop().
+    template <waveform_specification tSPEC>
+    requires (tSPEC.Timer != tim::peripheral::TIM_1)
+    class waveform {
+        static constexpr auto TimerSpec = tim::specification {
+            .Peripheral = tSPEC.Timer,
+            .Prescaler = tSPEC.Prescaler,
+            .Period = tSPEC.Period
+        };
+        static constexpr auto DmaSpec = dma::specification {
+            .Channel = tim::details::UpdateDMA_Channel<tSPEC.Timer>,
+            .Direction = dma::direction::MemoryToPeripheral,
+            .Increment = dma::increment::Memory,
+            .MemoryDataAlignment = dma::memory_alignment::Word,
+            .PeripheralDataAlignment = dma::peripheral_alignment::Word,
+            .Mode = tSPEC.Loop ? dma::mode::Circular : dma::mode::Normal,
+            .Priority = dma::priority::VeryHigh
+        };
+
+        using timer = tim::module<TimerSpec>;
+        using dma_module = dma::module<DmaSpec>;
+        using kernel = gpio::kernel<tSPEC.Port, pin::_0>;
+
+    public:
+        static constexpr std::array DmaChannels{ DmaSpec.Channel };
+
+        // Raised once the last word of a one-shot table has been written
+        callback Complete;
+
+    public:
+        waveform() noexcept
+        {
+            if constexpr (not tSPEC.Loop)
+                mDMA.TransferComplete.template Set<waveform, &waveform::finished>(*this);
+        }
+        ~waveform() noexcept { Stop(); }
+
+        status Play(std::span<uint32_t const> const table) noexcept
+        {
+            if (table.empty() or table.size() > 0xFFFF) [[unlikely]]
+                return status::Error;
+            if (mPlaying) [[unlikely]]
+                return status::Busy;
+
+            mPlaying = true;
+            mDMA.Start(reinterpret_cast<uintptr_t>(table.data()), kernel::BitSetResetAddress(), static_cast<uint16_t>(table.size()));
+            mTimer.Counter(0);
+            mTimer.UpdateDMA(ENABLED);
+            // The forced update requests the first word immediately; the rest follow every period
+            mTimer.GenerateUpdate();
+            mTimer.Start();
+            return status::OK;
+        }
+        void Stop() noexcept
+        {
+            mTimer.Stop();
+            mTimer.UpdateDMA(DISABLED);
+            mDMA.Abort();
+            mPlaying = false;
+        }
+        [[nodiscard]] bool IsPlaying() const noexcept { return mPlaying; }
+
+    private:
+        void finished() noexcept
+        {
+            mTimer.Stop();
+            mTimer.UpdateDMA(DISABLED);
+            mPlaying = false;
+            Complete();
+        }
+
+    private:
+        timer mTimer;
+        dma_module mDMA;
+
+        bool volatile mPlaying = false;
+    };
+}
@@ -96,6 +96,7 @@ public:
     constexpr void Clear() noexcept { mCallableObj.Clear(); }
 
     [[nodiscard]] constexpr bool IsValid() const noexcept { return mCallableObj; }
+    [[nodiscard]] constexpr bool operator ==(delegate const& rhs) const noexcept { return mCallableObj == rhs.mCallableObj; }
     [[nodiscard]] constexpr operator bool() const noexcept { return IsValid(); }
 
     tReturn operator()(tArgs... args) const noexcept
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#include "utils/utility.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc/rcc.hpp"
+#include "exti/exti.hpp"
+#include "gpio/gpio.hpp"
+#include "tim/tim.hpp"
+
+namespace hal::input {
+
+    struct edge {
+        gpio::pin Pin;
+        gpio::pin_state Level;
+        // Timer ticks at the start of the bounce: the Notify() call for pins that report their EXTI
+        // edge, otherwise the first sample that saw the change (sample-period resolution)
+        uint32_t Timestamp;
+    };
+
+    ////////////////////////////////
+    // Specification
+    ////////////////////////////////
+    struct specification {
+        gpio::port const Port;
+        uint16_t const Pins;
+        tim::peripheral const Timer;
+        // Defaults give 1 us ticks and a 1 ms sample period from a 72 MHz timer clock
+        uint16_t const Prescaler = 71;
+        uint16_t const Period = 999;
+        // Pins whose EXTI line is masked while they bounce; the EXTI source must be this port
+        uint16_t const ExtiMask = 0;
+        uint8_t const Priority = 6;
+    };
+
+    ////////////////////////////////
+    // Debouncer
+    ////////////////////////////////
+    // Debounces up to 16 pins of one port from a single periodic timer ISR: one IDR read per sample
+    // feeds a vertical counter (two bit-planes, so every pin is counted in parallel), and a pin
+    // changes state after four consecutive samples disagree with it. Each accepted change is
+    // reported once through Edge. Pins listed in ExtiMask have their EXTI line masked while they
+    // bounce and unmasked once they settle. Calling Notify(pin) from the line's EXTI callback masks it
+    // on the first edge and stamps it with Now(), so the line raises one interrupt per press; without
+    // it the mask only lands at the next sample and edges within that period still interrupt. The
+    // pins themselves are configured by their owner (gpio::module, gpio::board_config).
+    //
+    //     exti::module<...> button(exti::mode::Interrupt, exti::trigger::Both, callback::Create<&on_button>());
+    //     void on_button() { gDebouncer.Notify(gpio::pin::_3); }
+    template <specification tSPEC>
+    requires (tSPEC.Pins != 0 and (tSPEC.ExtiMask & ~tSPEC.Pins) == 0 and tSPEC.Timer != tim::peripheral::TIM_1)
+    class debouncer
+        : private rcc::clock_handler<gpio::details::PCLK<tSPEC.Port>>
+    {
+        using pclk = rcc::clock_handler<gpio::details::PCLK<tSPEC.Port>>;
+        using IDR = gpio::registers<tSPEC.Port, gpio::pin::_0>::idr;
+        using IMR = exti::registers<exti::line::_0>::imr;
+        using PR = exti::registers<exti::line::_0>::pr;
+
+        static constexpr auto TimerSpec = tim::specification {
+            .Peripheral = tSPEC.Timer,
+            .Prescaler = tSPEC.Prescaler,
+            .Period = tSPEC.Period,
+            .Priority = tSPEC.Priority
+        };
+        static constexpr uint32_t TICKS = static_cast<uint32_t>(tSPEC.Period) + 1u;
+
+    public:
+        delegate<void(edge const&)> Edge;
+
+    public:
+        debouncer() noexcept
+            : pclk()
+        {
+            mTimer.Update.template Set<debouncer, &debouncer::sample>(*this);
+        }
+        ~debouncer() noexcept { Stop(); }
+
+        void Start() noexcept
+        {
+            mState = read();
+            mCount0 = 0xFFFF;
+            mCount1 = 0xFFFF;
+            mBouncing = 0;
+            mNotified = 0;
+            mTimer.UpdateInterrupt(ENABLED);
+            mTimer.Start();
+        }
+        void Stop() noexcept
+        {
+            mTimer.Stop();
+            mTimer.UpdateInterrupt(DISABLED);
+            system::critical_section lock;
+            unmask(mBouncing);
+            mBouncing = 0;
+            mNotified = 0;
+        }
+        // Debounced levels of the configured pins, one bit per port pin
+        [[nodiscard]] uint16_t State() const noexcept { return mState; }
+        [[nodiscard]] bool IsHigh(gpio::pin const pin) const noexcept { return (mState >> EnumValue(pin)) & 1u; }
+        // Timer ticks since Start(), wrapping at 2^32
+        [[nodiscard]] uint32_t Now() const noexcept { return mTime + mTimer.Counter(); }
+        // Call from the EXTI callback of a pin in ExtiMask: masks its line until the pin settles and
+        // timestamps the edge that started the bounce
+        void Notify(gpio::pin const pin) noexcept
+        {
+            uint16_t const bit = static_cast<uint16_t>((1u << EnumValue(pin)) & tSPEC.ExtiMask);
+            if (not bit) [[unlikely]]
+                return;
+
+            system::critical_section lock;
+            IMR::REG.Write(IMR::REG.Read() & ~static_cast<uint32_t>(bit));
+            if (not (mNotified & bit))
+                mStart[EnumValue(pin)] = Now();
+            mNotified = mNotified | bit;
+            mBouncing = mBouncing | bit;
+        }
+
+    private:
+        [[nodiscard]] static uint16_t read() noexcept { return static_cast<uint16_t>(IDR::REG.Read() & tSPEC.Pins); }
+        void sample() noexcept
+        {
+            mTime = mTime + TICKS;
+            uint16_t const changed = mState ^ read();
+
+            // Two-bit vertical counter per pin: idle at 3, counts down while the pin disagrees
+            uint16_t const starting = changed & mCount0 & mCount1;
+            mCount0 = static_cast<uint16_t>(~(mCount0 & changed));
+            mCount1 = static_cast<uint16_t>(mCount0 ^ (mCount1 & changed));
+            uint16_t const toggled = changed & mCount0 & mCount1;
+            mState = mState ^ toggled;
+
+            if constexpr (tSPEC.ExtiMask != 0) {
+                // Notify() may run from a higher-priority EXTI ISR
+                system::critical_section lock;
+                for (uint16_t bits = starting & static_cast<uint16_t>(~mNotified); bits; bits &= bits - 1u)
+                    mStart[std::countr_zero(bits)] = mTime;
+
+                uint16_t const masked = starting & tSPEC.ExtiMask & static_cast<uint16_t>(~mBouncing);
+                if (masked)
+                    IMR::REG.Write(IMR::REG.Read() & ~static_cast<uint32_t>(masked));
+                mBouncing = (mBouncing | masked);
+                // Settled: the counter is idle again, whether the change was accepted or rejected
+                uint16_t const settled = mBouncing & static_cast<uint16_t>(~changed | toggled);
+                mBouncing = mBouncing & ~settled;
+                mNotified = mNotified & ~settled;
+                unmask(settled);
+            }
+            else {
+                for (uint16_t bits = starting; bits; bits &= bits - 1u)
+                    mStart[std::countr_zero(bits)] = mTime;
+            }
+
+            for (uint16_t bits = toggled; bits; bits &= bits - 1u) {
+                uint8_t const index = static_cast<uint8_t>(std::countr_zero(bits));
+                Edge.CallIf(edge{ static_cast<gpio::pin>(index), static_cast<gpio::pin_state>((mState >> index) & 1u), mStart[index] });
+            }
+        }
+        // Drops the edges latched while masked, then re-enables the lines
+        static void unmask(uint16_t const lines) noexcept
+        {
+            if (not lines)
+                return;
+            PR::REG.Write(lines);
+            IMR::REG.Write(IMR::REG.Read() | lines);
+        }
+
+    private:
+        tim::module<TimerSpec> mTimer;
+
+        uint16_t mState = 0;
+        uint16_t mCount0 = 0xFFFF;
+        uint16_t mCount1 = 0xFFFF;
+        uint16_t mBouncing = 0;
+        uint16_t mNotified = 0;
+        uint32_t mTime = 0;
+        uint32_t mStart[16]{};
+    };
+}
@@ -1,14 +1,24 @@
 #pragma once
 
 #include "utils/utility.hpp"
+#include "system/cycles.hpp"
+#include "system/interrupt.hpp"
 
 #include "rcc_kernel.hpp"
 
 namespace hal::rcc {
 
+    template <cValidClock auto tCLK, bool tENABLED>
+    class clock_activity;
+
     ////////////////////////////////
     // clock_handler
     ////////////////////////////////
+    // Every owner keeps the clock running from construction to destruction. Owners that gate it
+    // call Release() once configured and bracket each operation with Acquire()/Release() (or a
+    // clock_activity), so the clock stops whenever no owner is busy; registers keep their
+    // contents while gated, but writes are ignored, so a gating owner re-acquires the clock in its
+    // destructor before touching the peripheral.
     template <cValidClock auto tCLK>
     class clock_handler {
     protected:
@@ -17,15 +27,22 @@ namespace hal::rcc {
         clock_handler()
         {
             if (not sRefCount++)
-                kernel::ClockState<tCLK>(ENABLED);
+                sActiveCycles = 0;
+            Acquire();
         }
         ~clock_handler()
         {
+            system::critical_section lock;
+            --sUsers;
             if (not --sRefCount) {
                 if constexpr (cPeripheralClock<type>)
                     kernel::ResetPeripheral<tCLK>();
 
-                kernel::ClockState<tCLK>(DISABLED);
+                gate();
+                sUsers = 0;
+            }
+            else if (not sUsers) {
+                gate();
             }
         }
         static void Reset() noexcept
@@ -40,7 +57,50 @@ namespace hal::rcc {
         }
         static uint8_t ReferenceCount() noexcept { return sRefCount; }
 
+        static void Acquire() noexcept
+        {
+            system::critical_section lock;
+            if (not sUsers++) {
+                kernel::ClockState<tCLK>(ENABLED);
+                sEnabledAt = system::cycle_counter::Now();
+            }
+        }
+        static void Release() noexcept
+        {
+            system::critical_section lock;
+            if (not --sUsers)
+                gate();
+        }
+
+    public:
+        [[nodiscard]] static bool IsRunning() noexcept { return sUsers != 0; }
+        // HCLK cycles the clock has run since its first owner was created; needs
+        // system::cycle_counter::Enable(). A running clock is folded into the total on every call,
+        // so one that is never gated must be sampled at least once per CYCCNT wrap (~59 s at 72 MHz)
+        [[nodiscard]] static uint64_t ActiveCycles() noexcept
+        {
+            system::critical_section lock;
+            if (sUsers)
+                fold();
+            return sActiveCycles;
+        }
+
     private:
+        template <cValidClock auto, bool>
+        friend class clock_activity;
+
+        static void gate() noexcept
+        {
+            kernel::ClockState<tCLK>(DISABLED);
+            fold();
+        }
+        static void fold() noexcept
+        {
+            uint32_t const now = system::cycle_counter::Now();
+            sActiveCycles = sActiveCycles + (now - sEnabledAt);
+            sEnabledAt = now;
+        }
+
         clock_handler(clock_handler const&) = delete;
         clock_handler(clock_handler&&) = delete;
         clock_handler& operator=(clock_handler const&) = delete;
@@ -48,5 +108,32 @@ namespace hal::rcc {
 
     private:
         inline static uint8_t sRefCount = 0;
+        inline static uint8_t sUsers = 0;
+        inline static uint32_t sEnabledAt = 0;
+        inline static uint64_t sActiveCycles = 0;
+    };
+
+    ////////////////////////////////
+    // clock_activity
+    ////////////////////////////////
+    // Keeps a gated clock running for its scope; compiles to nothing when tENABLED is false, so
+    // drivers can gate per specification
+    template <cValidClock auto tCLK, bool tENABLED = true>
+    class clock_activity {
+    public:
+        clock_activity() noexcept
+        {
+            if constexpr (tENABLED)
+                clock_handler<tCLK>::Acquire();
+        }
+        ~clock_activity() noexcept
+        {
+            if constexpr (tENABLED)
+                clock_handler<tCLK>::Release();
+        }
+
+    private:
+        clock_activity(clock_activity const&) = delete;
+        clock_activity& operator=(clock_activity const&) = delete;
     };
-}
\ No newline at end of file
+}
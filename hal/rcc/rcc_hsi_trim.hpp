@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "stm32f103xb.h"
+
+#include "utils/utility.hpp"
+#include "system/clock_scaling.hpp"
+#include "system/cycles.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc.hpp"
+
+namespace hal::rcc {
+
+    ////////////////////////////////
+    // HSI Trim Specification
+    ////////////////////////////////
+    struct hsi_trim_specification {
+        uint32_t const LSE_Frequency = 32768;
+        // RTC prescaler; set when the trimmer starts the RTC, and must match the application's
+        // when the RTC already runs from the LSE. 32767 gives the usual 1 Hz RTC
+        uint32_t const RtcPrescaler = 32767;
+        // LSE periods per measurement, fewer than RtcPrescaler; 1024 takes ~31 ms and resolves the
+        // HSI to about 15 ppm
+        uint16_t const Window = 1024;
+    };
+
+    ////////////////////////////////
+    // HSI Trimmer
+    ////////////////////////////////
+    // Calibrates the HSI against the 32.768 kHz crystal. The RTC divider, clocked by the LSE, is
+    // timed with the DWT cycle counter, which runs from the HSI whenever SYSCLK derives from it;
+    // interrupts are masked only while waiting for the LSE edges that open and close the window.
+    // Trim() steps HSITRIM towards HSI_VALUE, then hands the residual error to
+    // system::clock_scaling, so listeners (usart::module) compute their divisors from the measured
+    // clock. Drift follows temperature and supply voltage, so call Trim() periodically.
+    //
+    //     rcc::hsi_trimmer<rcc::hsi_trim_specification{}> trimmer;
+    //     system::clock_listener uart_timing{ uart };
+    //     trimmer.Trim();
+    template <hsi_trim_specification tSPEC>
+    requires (tSPEC.Window > 1u and tSPEC.Window < tSPEC.RtcPrescaler and tSPEC.RtcPrescaler <= 0xFFFFFu)
+    class hsi_trimmer
+        : private clock_handler<pclk1::PWR_>
+        , private clock_handler<pclk1::BKP_>
+    {
+        using pwr = clock_handler<pclk1::PWR_>;
+        using bkp = clock_handler<pclk1::BKP_>;
+
+        static constexpr uint32_t PERIOD = tSPEC.RtcPrescaler + 1u;
+        static constexpr int32_t TRIM_STEP = 40_kHz;
+        static constexpr int32_t TRIM_MAX = 31;
+        static constexpr uint8_t ATTEMPTS = 4;
+
+        struct sample {
+            uint32_t Divider;
+            uint32_t Cycles;
+        };
+
+    public:
+        hsi_trimmer() noexcept
+            : pwr()
+            , bkp()
+        {
+            if (not system::cycle_counter::IsEnabled())
+                system::cycle_counter::Enable();
+
+            PWR->CR = PWR->CR | PWR_CR_DBP;
+            // RTCSEL can only be written once per backup domain reset
+            if (kernel::RtcSource() == rtc_source::None) {
+                kernel::SourceClockState<source_clock::LSE>(ENABLED);
+                kernel::SetProperty(rtc_source::LSE);
+                kernel::SourceClockState<source_clock::RTCLK>(ENABLED);
+                set_prescaler();
+            }
+            mUsable = (kernel::RtcSource() == rtc_source::LSE);
+            if (mUsable)
+                synchronise();
+        }
+
+        // HSI frequency in Hz, or 0 when SYSCLK does not derive from the HSI or the RTC is not
+        // clocked by the LSE
+        [[nodiscard]] uint32_t Measure() const noexcept
+        {
+            if (not mUsable or not system::clock_scaling::FromHSI())
+                return 0;
+
+            sample const first = edge();
+            while (elapsed(first.Divider, divider()) < tSPEC.Window - 1u);
+            sample const last = edge();
+
+            // DWT counts HCLK cycles; scale back to the HSI through the nominal profile
+            uint64_t const cycles = last.Cycles - first.Cycles;
+            uint64_t const ticks = elapsed(first.Divider, last.Divider);
+            uint64_t const hclk = system::clock_scaling::Current().Frequencies.HCLK;
+            return static_cast<uint32_t>((cycles * tSPEC.LSE_Frequency * HSI_VALUE) / (ticks * hclk));
+        }
+        // Steps HSITRIM until the HSI is within half a step of HSI_VALUE, then publishes the
+        // measured frequency; returns it, or 0 when Measure() cannot run
+        uint32_t Trim() noexcept
+        {
+            uint32_t hsi = Measure();
+            if (not hsi)
+                return 0;
+
+            for (uint8_t attempt = 0; attempt < ATTEMPTS; ++attempt) {
+                int32_t const error = static_cast<int32_t>(HSI_VALUE) - static_cast<int32_t>(hsi);
+                int32_t const steps = (error + ((error < 0) ? -TRIM_STEP / 2 : TRIM_STEP / 2)) / TRIM_STEP;
+                int32_t const trim = std::clamp<int32_t>(kernel::HsiTrim() + steps, 0, TRIM_MAX);
+                if (trim == kernel::HsiTrim())
+                    break;
+
+                kernel::HsiTrim(static_cast<uint8_t>(trim));
+                hsi = Measure();
+            }
+            system::clock_scaling::Calibrate(hsi);
+            return hsi;
+        }
+        [[nodiscard]] static uint8_t Trimming() noexcept { return kernel::HsiTrim(); }
+
+    private:
+        // The RTC divider counts LSE periods down from the prescaler value
+        [[nodiscard]] static uint32_t divider() noexcept
+        {
+            uint32_t value;
+            do {
+                value = ((RTC->DIVH & RTC_DIVH_RTC_DIV) << 16u) | RTC->DIVL;
+            } while (value != (((RTC->DIVH & RTC_DIVH_RTC_DIV) << 16u) | RTC->DIVL));
+            return value;
+        }
+        [[nodiscard]] static uint32_t elapsed(uint32_t const from, uint32_t const to) noexcept { return (from + PERIOD - to) % PERIOD; }
+        // Cycle count at the first LSE edge from now
+        [[nodiscard]] static sample edge() noexcept
+        {
+            system::critical_section lock;
+            uint32_t const start = divider();
+            uint32_t now;
+            while ((now = divider()) == start);
+            return { now, system::cycle_counter::Now() };
+        }
+        static void synchronise() noexcept
+        {
+            RTC->CRL = RTC->CRL & ~RTC_CRL_RSF;
+            while (not (RTC->CRL & RTC_CRL_RSF));
+        }
+        static void set_prescaler() noexcept
+        {
+            while (not (RTC->CRL & RTC_CRL_RTOFF));
+            RTC->CRL = RTC->CRL | RTC_CRL_CNF;
+            RTC->PRLH = (tSPEC.RtcPrescaler >> 16u) & RTC_PRLH_PRL;
+            RTC->PRLL = tSPEC.RtcPrescaler & RTC_PRLL_PRL;
+            RTC->CRL = RTC->CRL & ~RTC_CRL_CNF;
+            while (not (RTC->CRL & RTC_CRL_RTOFF));
+        }
+
+    private:
+        bool mUsable = false;
+    };
+}
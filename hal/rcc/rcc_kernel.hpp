@@ -102,6 +102,10 @@ namespace hal::rcc {
       , x15
       , x16
     };
+    enum class usb_prescaler :uint32_t {
+        Div1_5
+      , Div1
+    };
     enum class adc_prescaler :uint32_t {
         Div2
       , Div4
@@ -142,6 +146,7 @@ namespace hal::rcc {
         or std::same_as<std::remove_cvref_t<T>, pll_source>
         or std::same_as<std::remove_cvref_t<T>, pll_multiplier>
         or std::same_as<std::remove_cvref_t<T>, adc_prescaler>
+        or std::same_as<std::remove_cvref_t<T>, usb_prescaler>
         or std::same_as<std::remove_cvref_t<T>, hclk_prescaler>
         or std::same_as<std::remove_cvref_t<T>, pclk2_prescaler>
         or std::same_as<std::remove_cvref_t<T>, pclk1_prescaler>;
@@ -263,6 +268,10 @@ namespace hal::rcc {
             if constexpr (tPCLK == pclk1::PWR_)    { APB1RSTR::PWRRST.Set(); APB1RSTR::PWRRST.Reset(); }
             if constexpr (tPCLK == pclk1::USB_)    { APB1RSTR::USBRST.Set(); APB1RSTR::USBRST.Reset(); }
         }
+        // HSITRIM, 0..31 with 16 as the factory centre; one step moves the HSI by roughly 40 kHz
+        static void HsiTrim(uint8_t const trim) noexcept { CR::HSITRIM.Write(trim); }
+        [[nodiscard]] static uint8_t HsiTrim() noexcept { return static_cast<uint8_t>(CR::HSITRIM.Read()); }
+        [[nodiscard]] static rtc_source RtcSource() noexcept { return static_cast<rtc_source>(BDCR::RTCSEL.Read()); }
         static void SetProperty(hclk_source const source) noexcept
         {
             if (auto const tmp{ EnumValue(source) }; tmp != CFGR::SWS.Read()) {
@@ -283,6 +292,7 @@ namespace hal::rcc {
         static void SetProperty(pclk2_prescaler const prescaler) noexcept { CFGR::PPRE2.Write(EnumValue(prescaler)); }
         static void SetProperty(pclk1_prescaler const prescaler) noexcept { CFGR::PPRE1.Write(EnumValue(prescaler)); }
         static void SetProperty(adc_prescaler const prescaler) noexcept { CFGR::ADCPRE.Write(EnumValue(prescaler)); }
+        static void SetProperty(usb_prescaler const prescaler) noexcept { CFGR::USBPRE.Write(EnumValue(prescaler)); }
         static void Configure(cValidProperty auto const... property) noexcept { ( SetProperty(property), ... ); }
     };
 }
@@ -0,0 +1,472 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+
+#include "include/expected.hpp"
+
+#include "utils/utility.hpp"
+#include "system/tick.hpp"
+
+#include "gpio/gpio.hpp"
+#include "spi/spi.hpp"
+
+namespace hal::sdcard {
+
+    static constexpr uint16_t BlockSize = 512;
+
+    enum class card_type :uint8_t {
+         None
+        ,SDv1
+        ,SDv2
+        ,SDHC
+    };
+
+    ////////////////////////////////
+    // Specification
+    ////////////////////////////////
+    // InitPrescaler must keep SCLK at or below 400 kHz; FastPrescaler at or below 25 MHz.
+    // CheckDataCrc verifies the CRC16 the card appends to every data block it sends (~50 us per
+    // 512-byte block at 72 MHz).
+    struct specification {
+        gpio::port const SelectPort;
+        gpio::pin const SelectPin;
+        spi::clock_prescaler const InitPrescaler = spi::clock_prescaler::Div256;
+        spi::clock_prescaler const FastPrescaler = spi::clock_prescaler::Div4;
+        bool const CheckDataCrc = true;
+    };
+
+    ////////////////////////////////
+    // Card
+    ////////////////////////////////
+    // SD/MMC block device on an 8-bit TxRx spi::module with DmaTransfers. Data blocks move by DMA;
+    // multi-block reads and writes use CMD18/CMD25 so the card streams without per-block command
+    // overhead.
+    template <typename tSPI, specification tSPEC>
+    requires std::same_as<typename tSPI::data_type, uint8_t>
+    class card {
+        static constexpr auto SelectPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = tSPEC.SelectPort,
+            .Pin = tSPEC.SelectPin,
+            .OutputMode = gpio::output_mode::GP_PushPull,
+            .OutputSpeed = gpio::output_speed::_50MHz
+        };
+        using select_pin = gpio::module<SelectPinSpec>;
+
+        enum command_index :uint8_t {
+             GO_IDLE_STATE = 0
+            ,SEND_OP_COND = 1
+            ,SEND_IF_COND = 8
+            ,SEND_CSD = 9
+            ,STOP_TRANSMISSION = 12
+            ,SET_BLOCKLEN = 16
+            ,READ_SINGLE_BLOCK = 17
+            ,READ_MULTIPLE_BLOCK = 18
+            ,SET_BLOCK_COUNT = 23
+            ,WRITE_BLOCK = 24
+            ,WRITE_MULTIPLE_BLOCK = 25
+            ,APP_SEND_OP_COND = 41
+            ,APP_CMD = 55
+            ,READ_OCR = 58
+        };
+
+        static constexpr uint8_t R1_IDLE = 0x01;
+        static constexpr uint8_t TOKEN_START_BLOCK = 0xFE;
+        static constexpr uint8_t TOKEN_START_MULTI_WRITE = 0xFC;
+        static constexpr uint8_t TOKEN_STOP_TRAN = 0xFD;
+        static constexpr uint8_t DATA_ACCEPTED = 0x05;
+
+        static constexpr uint32_t INIT_TIMEOUT = 1000_mS;
+        static constexpr uint32_t READ_TIMEOUT = 100_mS;
+        static constexpr uint32_t WRITE_TIMEOUT = 500_mS;
+
+        enum class async_state :uint8_t {
+             Idle
+            ,WaitToken
+            ,Data
+        };
+
+    public:
+        using complete_callback = delegate<void(status const)>;
+
+    public:
+        explicit card(tSPI& spi) noexcept
+            : mSPI(spi)
+            , mSelect(gpio::pin_state::High)
+        {}
+
+        status Initialize() noexcept
+        {
+            mType = card_type::None;
+            mSPI.SetClockPrescaler(tSPEC.InitPrescaler);
+
+            // At least 74 clocks with CS and DI high put the card in native mode
+            for (uint8_t i = 0; i != 10u; ++i)
+                (void)exchange(0xFF);
+
+            system::timer watchdog(INIT_TIMEOUT, true);
+            status result = status::Error;
+            if (command(GO_IDLE_STATE, 0) == R1_IDLE) {
+                card_type type = card_type::None;
+                uint8_t ocr[4];
+
+                if (command(SEND_IF_COND, 0x1AA) == R1_IDLE) {
+                    receive(ocr, sizeof(ocr));
+                    if (ocr[2] == 0x01 and ocr[3] == 0xAA) {
+                        while (app_command(APP_SEND_OP_COND, 1ul << 30) != 0) {
+                            if (watchdog.IsExpired())
+                                break;
+                        }
+                        if (not watchdog.IsExpired() and command(READ_OCR, 0) == 0) {
+                            receive(ocr, sizeof(ocr));
+                            type = (ocr[0] & 0x40) ? card_type::SDHC : card_type::SDv2;
+                        }
+                    }
+                }
+                else {
+                    bool const sd = (app_command(APP_SEND_OP_COND, 0) <= R1_IDLE);
+                    while ((sd ? app_command(APP_SEND_OP_COND, 0) : command(SEND_OP_COND, 0)) != 0) {
+                        if (watchdog.IsExpired())
+                            break;
+                    }
+                    if (not watchdog.IsExpired() and command(SET_BLOCKLEN, BlockSize) == 0)
+                        type = card_type::SDv1;
+                }
+                mType = type;
+                result = (type != card_type::None) ? status::OK : status::TimedOut;
+            }
+            deselect();
+
+            if (result == status::OK)
+                mSPI.SetClockPrescaler(tSPEC.FastPrescaler);
+            return result;
+        }
+        [[nodiscard]] card_type Type() const noexcept { return mType; }
+        [[nodiscard]] expected<uint32_t, status> BlockCount() noexcept
+        {
+            uint8_t csd[16];
+            status const result = (command(SEND_CSD, 0) == 0) ? receive_block(csd, sizeof(csd)) : status::Error;
+            deselect();
+            if (result != status::OK)
+                return MakeUnexpected(result);
+
+            if ((csd[0] >> 6) == 1u) {
+                uint32_t const c_size = (static_cast<uint32_t>(csd[7] & 0x3F) << 16) | (static_cast<uint32_t>(csd[8]) << 8) | csd[9];
+                return (c_size + 1u) << 10u;
+            }
+            uint32_t const read_bl_len = csd[5] & 0x0F;
+            uint32_t const c_size = (static_cast<uint32_t>(csd[6] & 0x03) << 10) | (static_cast<uint32_t>(csd[7]) << 2) | (csd[8] >> 6);
+            uint32_t const c_size_mult = ((csd[9] & 0x03) << 1) | (csd[10] >> 7);
+            return (c_size + 1u) << (c_size_mult + 2u + read_bl_len - 9u);
+        }
+
+        ////////////////////////////////
+        // Blocking transfers
+        ////////////////////////////////
+        status ReadBlocks(uint32_t const block, uint8_t* data, uint32_t const count) noexcept
+        {
+            if (count == 0 or mAsync != async_state::Idle) [[unlikely]]
+                return status::Error;
+
+            status result = status::Error;
+            if (count == 1u) {
+                if (command(READ_SINGLE_BLOCK, address(block)) == 0)
+                    result = receive_block(data, BlockSize);
+            }
+            else if (command(READ_MULTIPLE_BLOCK, address(block)) == 0) {
+                for (uint32_t i = 0; i != count; ++i, data += BlockSize) {
+                    result = receive_block(data, BlockSize);
+                    if (result != status::OK)
+                        break;
+                }
+                stop_transmission();
+            }
+            deselect();
+            return result;
+        }
+        status WriteBlocks(uint32_t const block, uint8_t const* data, uint32_t const count) noexcept
+        {
+            if (count == 0 or mAsync != async_state::Idle) [[unlikely]]
+                return status::Error;
+
+            status result = status::Error;
+            if (count == 1u) {
+                if (command(WRITE_BLOCK, address(block)) == 0)
+                    result = transmit_block(TOKEN_START_BLOCK, data);
+            }
+            else {
+                // Pre-erase hint; lets the card allocate the whole run up front
+                (void)app_command(SET_BLOCK_COUNT, count);
+
+                if (command(WRITE_MULTIPLE_BLOCK, address(block)) == 0) {
+                    for (uint32_t i = 0; i != count; ++i, data += BlockSize) {
+                        result = transmit_block(TOKEN_START_MULTI_WRITE, data);
+                        if (result != status::OK)
+                            break;
+                    }
+                    (void)exchange(TOKEN_STOP_TRAN);
+                    (void)exchange(0xFF);
+                    if (wait_ready(WRITE_TIMEOUT) != status::OK)
+                        result = status::TimedOut;
+                }
+            }
+            deselect();
+            return result;
+        }
+
+        ////////////////////////////////
+        // Asynchronous read-ahead
+        ////////////////////////////////
+        // Streams count blocks with CMD18; each block is DMA'd straight into data. Service() must be
+        // called from the main loop; BlocksRead() lets the caller consume earlier blocks while later
+        // ones are still arriving. complete runs from Service() once the stream is closed.
+        status ReadBlocksAsync(uint32_t const block, uint8_t* data, uint32_t const count, complete_callback const& complete = {}) noexcept
+        {
+            if (count == 0) [[unlikely]]
+                return status::Error;
+            if (mAsync != async_state::Idle) [[unlikely]]
+                return status::Busy;
+
+            if (command(READ_MULTIPLE_BLOCK, address(block)) != 0) {
+                deselect();
+                return status::Error;
+            }
+            mAsyncData = data;
+            mAsyncCount = count;
+            mAsyncDone = 0;
+            mAsyncComplete = complete;
+            mAsyncWatchdog.Start(READ_TIMEOUT);
+            mAsync = async_state::WaitToken;
+            return status::OK;
+        }
+        void Service() noexcept
+        {
+            switch (mAsync) {
+            case async_state::WaitToken: {
+                uint8_t const token = exchange(0xFF);
+                if (token == TOKEN_START_BLOCK) {
+                    mAsync = async_state::Data;
+                    if (mSPI.template Transfer<tSPI::DMA>(nullptr, mAsyncData, BlockSize) != status::OK)
+                        finish_async(status::Error);
+                }
+                else if (token != 0xFF) {
+                    finish_async(status::Error);
+                }
+                else if (mAsyncWatchdog.IsExpired()) {
+                    finish_async(status::TimedOut);
+                }
+                break;
+            }
+            case async_state::Data:
+                if (mSPI.IsBusy())
+                    break;
+
+                if (not block_crc_matches(mAsyncData, BlockSize)) {
+                    finish_async(status::Error);
+                    break;
+                }
+                mAsyncData += BlockSize;
+                mAsyncDone = mAsyncDone + 1u;
+                if (mAsyncDone == mAsyncCount) {
+                    finish_async(status::OK);
+                }
+                else {
+                    mAsyncWatchdog.Start(READ_TIMEOUT);
+                    mAsync = async_state::WaitToken;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        [[nodiscard]] bool IsBusy() const noexcept { return mAsync != async_state::Idle; }
+        [[nodiscard]] uint32_t BlocksRead() const noexcept { return mAsyncDone; }
+
+    private:
+        static constexpr uint8_t crc7(uint8_t const* data, uint8_t const size) noexcept
+        {
+            uint8_t crc = 0;
+            for (uint8_t i = 0; i != size; ++i) {
+                uint8_t byte = data[i];
+                for (uint8_t bit = 0; bit != 8u; ++bit, byte <<= 1) {
+                    crc <<= 1;
+                    if ((byte ^ crc) & 0x80)
+                        crc ^= 0x09;
+                }
+            }
+            return static_cast<uint8_t>((crc << 1) | 1u);
+        }
+        // CRC-16/XMODEM (polynomial 0x1021, initial value 0), one table lookup per byte. The SPI
+        // hardware CRC follows the frame width, so an 8-bit bus can only compute CRC-8
+        static constexpr auto CRC16_TABLE = []() consteval noexcept {
+            std::array<uint16_t, 256> table{};
+            for (uint16_t i = 0; i != table.size(); ++i) {
+                uint16_t crc = static_cast<uint16_t>(i << 8);
+                for (uint8_t bit = 0; bit != 8u; ++bit)
+                    crc = static_cast<uint16_t>((crc & 0x8000u) ? ((crc << 1) ^ 0x1021u) : (crc << 1));
+                table[i] = crc;
+            }
+            return table;
+        }();
+        [[nodiscard]] static uint16_t crc16(uint8_t const* data, uint16_t const size) noexcept
+        {
+            uint16_t crc = 0;
+            for (uint16_t i = 0; i != size; ++i)
+                crc = static_cast<uint16_t>((crc << 8) ^ CRC16_TABLE[(crc >> 8) ^ data[i]]);
+            return crc;
+        }
+        [[nodiscard]] uint32_t address(uint32_t const block) const noexcept
+        {
+            return (mType == card_type::SDHC) ? block : block * BlockSize;
+        }
+        uint8_t exchange(uint8_t value) noexcept
+        {
+            uint8_t rx = 0xFF;
+            (void)mSPI.template Transfer<tSPI::BLOCKING>(&value, &rx, 1);
+            return rx;
+        }
+        void receive(uint8_t* data, size_t const size) noexcept
+        {
+            for (size_t i = 0; i != size; ++i)
+                data[i] = exchange(0xFF);
+        }
+        status wait_ready(uint32_t const timeout) noexcept
+        {
+            system::timer watchdog(timeout, true);
+            while (exchange(0xFF) != 0xFF) {
+                if (watchdog.IsExpired())
+                    return status::TimedOut;
+            }
+            return status::OK;
+        }
+        void select() noexcept
+        {
+            mSelect.ResetPin();
+            (void)exchange(0xFF);
+        }
+        void deselect() noexcept
+        {
+            mSelect.SetPin();
+            // One extra byte releases DO on MMC/SD cards
+            (void)exchange(0xFF);
+        }
+        uint8_t command(uint8_t const index, uint32_t const argument) noexcept
+        {
+            select();
+            if (index != GO_IDLE_STATE and index != STOP_TRANSMISSION) {
+                if (wait_ready(WRITE_TIMEOUT) != status::OK)
+                    return 0xFF;
+            }
+            uint8_t frame[6] = {
+                static_cast<uint8_t>(0x40 | index),
+                static_cast<uint8_t>(argument >> 24),
+                static_cast<uint8_t>(argument >> 16),
+                static_cast<uint8_t>(argument >> 8),
+                static_cast<uint8_t>(argument),
+                0
+            };
+            frame[5] = crc7(frame, 5);
+            for (uint8_t const byte : frame)
+                (void)exchange(byte);
+
+            // Stuff byte precedes the R1 of CMD12
+            if (index == STOP_TRANSMISSION)
+                (void)exchange(0xFF);
+
+            uint8_t r1 = 0xFF;
+            for (uint8_t retry = 0; retry != 10u and (r1 & 0x80); ++retry)
+                r1 = exchange(0xFF);
+            return r1;
+        }
+        uint8_t app_command(uint8_t const index, uint32_t const argument) noexcept
+        {
+            uint8_t const r1 = command(APP_CMD, 0);
+            if (r1 > R1_IDLE)
+                return r1;
+            return command(index, argument);
+        }
+        void stop_transmission() noexcept
+        {
+            (void)command(STOP_TRANSMISSION, 0);
+            (void)wait_ready(WRITE_TIMEOUT);
+        }
+        status wait_dma() noexcept
+        {
+            system::timer watchdog(WRITE_TIMEOUT, true);
+            while (mSPI.IsBusy()) {
+                if (watchdog.IsExpired())
+                    return status::TimedOut;
+            }
+            return status::OK;
+        }
+        status receive_block(uint8_t* data, uint16_t const size) noexcept
+        {
+            system::timer watchdog(READ_TIMEOUT, true);
+            uint8_t token;
+            while ((token = exchange(0xFF)) == 0xFF) {
+                if (watchdog.IsExpired())
+                    return status::TimedOut;
+            }
+            if (token != TOKEN_START_BLOCK)
+                return status::Error;
+
+            status const result = mSPI.template Transfer<tSPI::DMA>(nullptr, data, size);
+            if (result != status::OK)
+                return result;
+            if (wait_dma() != status::OK)
+                return status::TimedOut;
+
+            return block_crc_matches(data, size) ? status::OK : status::Error;
+        }
+        // Clocks in the CRC16 that follows a data block and compares it with the received data
+        bool block_crc_matches(uint8_t const* data, uint16_t const size) noexcept
+        {
+            uint16_t received = static_cast<uint16_t>(exchange(0xFF) << 8);
+            received = received | exchange(0xFF);
+
+            if constexpr (tSPEC.CheckDataCrc)
+                return received == crc16(data, size);
+            else
+                return true;
+        }
+        status transmit_block(uint8_t const token, uint8_t const* data) noexcept
+        {
+            if (wait_ready(WRITE_TIMEOUT) != status::OK)
+                return status::TimedOut;
+
+            (void)exchange(token);
+            // The SPI module only reads the transmit buffer
+            status const result = mSPI.template Transfer<tSPI::DMA>(const_cast<uint8_t*>(data), nullptr, BlockSize);
+            if (result != status::OK)
+                return result;
+            if (wait_dma() != status::OK)
+                return status::TimedOut;
+
+            (void)exchange(0xFF);
+            (void)exchange(0xFF);
+            if ((exchange(0xFF) & 0x1F) != DATA_ACCEPTED)
+                return status::Error;
+            return status::OK;
+        }
+        void finish_async(status const result) noexcept
+        {
+            stop_transmission();
+            deselect();
+            mAsync = async_state::Idle;
+            mAsyncComplete.CallIf(result);
+        }
+
+    private:
+        tSPI& mSPI;
+        select_pin mSelect;
+        card_type mType = card_type::None;
+
+        async_state volatile mAsync = async_state::Idle;
+        uint8_t* mAsyncData = nullptr;
+        uint32_t mAsyncCount = 0;
+        uint32_t volatile mAsyncDone = 0;
+        complete_callback mAsyncComplete;
+        system::timer mAsyncWatchdog;
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <concepts>
 #include <span>
@@ -7,10 +9,12 @@
 
 #include "stm32f103xb.h"
 #include "utils/utility.hpp"
+#include "system/clock.hpp"
 #include "system/interrupt.hpp"
 #include "system/tick.hpp"
 
 #include "rcc/rcc.hpp"
+#include "dma/dma.hpp"
 #include "gpio/gpio.hpp"
 
 #include "spi_kernel.hpp"
@@ -28,6 +32,39 @@ namespace hal::spi {
             if constexpr (tPeriph == peripheral::SPI_1) return system::peripheral_irq::SPI_1;
             else return system::peripheral_irq::SPI_2;
         }();
+        template <peripheral tPeriph>
+        constexpr auto RxDMA_Channel = []() consteval noexcept {
+            if constexpr (tPeriph == peripheral::SPI_1) return dma::channel::_2;
+            else return dma::channel::_4;
+        }();
+        template <peripheral tPeriph>
+        constexpr auto TxDMA_Channel = []() consteval noexcept {
+            if constexpr (tPeriph == peripheral::SPI_1) return dma::channel::_3;
+            else return dma::channel::_5;
+        }();
+        template <peripheral tPeriph, data_width tWIDTH>
+        static constexpr auto RxDMA_Spec = dma::specification {
+            .Channel = RxDMA_Channel<tPeriph>,
+            .Direction = dma::direction::PeripheralToMemory,
+            .Increment = dma::increment::Memory,
+            .MemoryDataAlignment = (tWIDTH == data_width::_8bit) ? dma::memory_alignment::Byte : dma::memory_alignment::HalfWord,
+            .PeripheralDataAlignment = (tWIDTH == data_width::_8bit) ? dma::peripheral_alignment::Byte : dma::peripheral_alignment::HalfWord,
+            .Mode = dma::mode::Normal,
+            .Priority = dma::priority::VeryHigh
+        };
+        template <peripheral tPeriph, data_width tWIDTH>
+        static constexpr auto TxDMA_Spec = dma::specification {
+            .Channel = TxDMA_Channel<tPeriph>,
+            .Direction = dma::direction::MemoryToPeripheral,
+            .Increment = dma::increment::Memory,
+            .MemoryDataAlignment = (tWIDTH == data_width::_8bit) ? dma::memory_alignment::Byte : dma::memory_alignment::HalfWord,
+            .PeripheralDataAlignment = (tWIDTH == data_width::_8bit) ? dma::peripheral_alignment::Byte : dma::peripheral_alignment::HalfWord,
+            .Mode = dma::mode::Normal,
+            .Priority = dma::priority::High
+        };
+        // Stands in for the DMA channels of a module built without DmaTransfers
+        struct null_dma {};
+
         template <peripheral tPeriph>
         static constexpr gpio::specification<gpio::pin_type::Output> sclkPinSpec {
             .Port = []() consteval noexcept {
@@ -82,6 +119,12 @@ namespace hal::spi {
         clock_polarity const ClockPolarity = clock_polarity::Low;
         clock_phase const ClockPhase = clock_phase::LeadingEdge;
         clock_prescaler const ClockPrescaler = clock_prescaler::Div2;
+        crc_polynomial const CrcPolynomial = crc_polynomial::None;
+        // Stops the peripheral clock whenever no transfer is in flight (rcc::clock_handler)
+        bool const ClockGating = false;
+        // Claims the RX/TX DMA channels and their IRQ callbacks for Transfer<DMA>; without it the
+        // channels stay free for other drivers (USART3, USART1, TIM2/TIM3 updates, memcpy)
+        bool const DmaTransfers = false;
     };
 
     template <typename T>
@@ -99,10 +142,29 @@ namespace hal::spi {
         using kernel = spi::kernel<tSPEC.Peripheral>;
         using irq = system::interrupt<details::IRQn<tSPEC.Peripheral>>;
         using pclk = rcc::clock_handler<details::PCLKn<tSPEC.Peripheral>>;
-        
+        using activity = rcc::clock_activity<details::PCLKn<tSPEC.Peripheral>, tSPEC.ClockGating>;
+
         using sclk_pin = gpio::module<details::sclkPinSpec<tSPEC.Peripheral>>;
+        static constexpr bool DMA_ENABLED = tSPEC.DmaTransfers;
+        static constexpr bool CRC_ENABLED = (tSPEC.CrcPolynomial != crc_polynomial::None);
+        static constexpr bool RX_DMA_ENABLED = DMA_ENABLED and (tSPEC.DataDirection != data_direction::TxOnly);
+
+        using rx_dma = std::conditional_t<DMA_ENABLED, dma::module<details::RxDMA_Spec<tSPEC.Peripheral, tSPEC.DataWidth>>, details::null_dma>;
+        using tx_dma = std::conditional_t<DMA_ENABLED, dma::module<details::TxDMA_Spec<tSPEC.Peripheral, tSPEC.DataWidth>>, details::null_dma>;
+
+        // Frames still in flight when TX DMA completes: one in DR and one in the shift register.
+        // The wait runs in the DMA ISR, where the tick may not advance, so it is bounded in polls
+        // (each at least one cycle) covering 16-bit frames at PCLK/256 with HCLK at twice PCLK
+        static constexpr uint32_t DRAIN_POLLS = 2u * 16u * 256u * 2u;
 
     public:
+        static constexpr auto DmaChannels = []() consteval noexcept {
+            if constexpr (DMA_ENABLED)
+                return std::array{ details::RxDMA_Channel<tSPEC.Peripheral>, details::TxDMA_Channel<tSPEC.Peripheral> };
+            else
+                return std::array<dma::channel, 0>{};
+        }();
+
         using miso_pin = std::conditional_t<
             (tSPEC.DataDirection == data_direction::TxOnly),
             gpio::null_pin,
@@ -118,9 +180,10 @@ namespace hal::spi {
     public:
         using callback = delegate<void()>;
 
-        enum transfer_type :bool {
+        enum transfer_type :uint8_t {
             BLOCKING
            ,INTERRUPT
+           ,DMA
         };
 
         class payload_buffer {
@@ -163,11 +226,18 @@ namespace hal::spi {
             : pclk()
             , irq(irq::callback::template Create<module, &module::isr>(*this), 1_u8, DISABLED)
         {
+            if constexpr (RX_DMA_ENABLED)
+                mRxDMA.TransferComplete.template Set<module, &module::end_dma_transfer>(*this);
+            if constexpr (DMA_ENABLED)
+                mTxDMA.TransferComplete.template Set<module, &module::end_tx_dma_transfer>(*this);
+
             kernel::Configure(tSPEC.Mode, tSPEC.DataWidth, tSPEC.BitOrder
-                ,tSPEC.SlaveSelect, tSPEC.ClockPolarity, tSPEC.ClockPhase, tSPEC.ClockPrescaler);
+                ,tSPEC.SlaveSelect, tSPEC.ClockPolarity, tSPEC.ClockPhase, tSPEC.ClockPrescaler, tSPEC.CrcPolynomial);
             kernel::State(ENABLED);
+            mSckLimit = sck_frequency(system::ActiveClock(), tSPEC.ClockPrescaler);
+            clock_idle();
         }
-        ~module() noexcept {}
+        ~module() noexcept { clock_busy(); }
 
         template <transfer_type tXFER>
         status Transfer(data_type* tx_data_ptr, data_type* rx_data_ptr, size_t const size, uint32_t timeout = 250_mS) noexcept
@@ -178,6 +248,8 @@ namespace hal::spi {
 
             if constexpr (tXFER == BLOCKING)
                 return blocking_transfer({tx_data_ptr, size}, {rx_data_ptr, size}, timeout);
+            else if constexpr (tXFER == DMA)
+                return dma_transfer(tx_data_ptr, rx_data_ptr, size);
 
             return status::Error;
         }
@@ -190,6 +262,8 @@ namespace hal::spi {
 
             if constexpr (tXFER == BLOCKING)
                 return blocking_transfer({tx_data_ptr, size}, {nullptr, size}, timeout);
+            else if constexpr (tXFER == DMA)
+                return dma_transfer(tx_data_ptr, nullptr, size);
 
             return status::Error;
         }
@@ -202,19 +276,76 @@ namespace hal::spi {
 
             if constexpr (tXFER == BLOCKING)
                 return blocking_transfer({nullptr, size}, {rx_data_ptr, size}, timeout);
+            else if constexpr (tXFER == DMA)
+                return dma_transfer(nullptr, rx_data_ptr, size);
 
             return status::Error;
         }
 
+        [[nodiscard]] bool IsBusy() const noexcept { return mBusy; }
+        // Frame width for blocking transfers; DMA transfers always use the specification width
+        void FrameWidth(data_width const width) noexcept
+        {
+            activity const busy;
+            kernel::State(DISABLED);
+            kernel::SetProperty(width);
+            kernel::State(ENABLED);
+        }
+        // Bus clock may only change between transfers
+        void SetClockPrescaler(clock_prescaler const prescaler) noexcept
+        {
+            activity const busy;
+            kernel::State(DISABLED);
+            kernel::SetProperty(prescaler);
+            kernel::State(ENABLED);
+            mSckLimit = sck_frequency(system::ActiveClock(), prescaler);
+        }
+        // Picks the fastest prescaler that keeps SCK at or below the rate last set through the
+        // specification or SetClockPrescaler; call between transfers (system::clock_listener).
+        // A 1/32 margin absorbs a calibrated HSI running slightly fast, which would otherwise
+        // double the divider and halve the throughput
+        void Retime(system::clock_frequencies const& clocks) noexcept
+        {
+            uint32_t const limit = mSckLimit + (mSckLimit / 32u);
+            uint8_t divider = 0;
+            while (divider < 7u and sck_frequency(clocks, static_cast<clock_prescaler>(divider)) > limit)
+                ++divider;
+            activity const busy;
+            kernel::State(DISABLED);
+            kernel::SetProperty(static_cast<clock_prescaler>(divider));
+            kernel::State(ENABLED);
+        }
+
         sclk_pin SCLK;
         miso_pin MISO;
         mosi_pin MOSI;
 
+        // DMA transfer completion; TransferError also reports hardware CRC mismatches and a bus
+        // that failed to drain
+        callback TransferComplete;
+        callback TransferError;
+
     private:
+        [[nodiscard]] static uint32_t sck_frequency(system::clock_frequencies const& clocks, clock_prescaler const prescaler) noexcept
+        {
+            uint32_t const pclk = (tSPEC.Peripheral == peripheral::SPI_1) ? clocks.PCLK2 : clocks.PCLK1;
+            return pclk >> (EnumValue(prescaler) + 1u);
+        }
         INLINE void isr() noexcept {}
+        INLINE static void clock_busy() noexcept
+        {
+            if constexpr (tSPEC.ClockGating)
+                pclk::Acquire();
+        }
+        INLINE static void clock_idle() noexcept
+        {
+            if constexpr (tSPEC.ClockGating)
+                pclk::Release();
+        }
 
         status blocking_transfer(payload_buffer tx, payload_buffer rx, uint32_t timeout = 250_mS) noexcept
         {
+            activity const busy;
             system::timer watch_dog(timeout, true);
 
             for (; rx and tx; ++rx, ++tx) {
@@ -222,6 +353,10 @@ namespace hal::spi {
                     return status::TimedOut;
 
                 kernel::WriteData(tx.IsValid() ? *tx : data_type{0});
+                if constexpr (CRC_ENABLED) {
+                    if (tx.Size() == 1u)
+                        kernel::CrcNext();
+                }
                 if (wait_for_flag_state<flag::RXNE>(ENABLED, watch_dog) != status::OK)
                     return status::TimedOut;
 
@@ -230,11 +365,96 @@ namespace hal::spi {
                 else
                     (void)kernel::ReadData();
             }
+            if constexpr (CRC_ENABLED) {
+                // The CRC frame follows the last data frame; its arrival latches CRCERR
+                if (wait_for_flag_state<flag::RXNE>(ENABLED, watch_dog) != status::OK)
+                    return status::TimedOut;
+                (void)kernel::ReadData();
+            }
             if (wait_for_flag_state<flag::BSY>(DISABLED, watch_dog) != status::OK)
                 return status::TimedOut;
 
+            if constexpr (CRC_ENABLED) {
+                if (kernel::template FlagState<flag::CRCERR>()) {
+                    kernel::template ClearFlag<flag::CRCERR>();
+                    kernel::ResetCrc();
+                    return status::Error;
+                }
+                kernel::ResetCrc();
+            }
             return status::OK;
         }
+        // Buffers are streamed in memory order. A null tx buffer sends all-ones dummy frames
+        // taken from the (pre-filled) rx buffer, so reads need no separate dummy array.
+        // A null rx buffer on a TxRx bus transmits only and discards the received frames.
+        status dma_transfer(data_type* tx, data_type* rx, size_t const size) noexcept
+        {
+            static_assert(DMA_ENABLED, "Transfer<DMA> needs specification::DmaTransfers");
+
+            if (size == 0u or size > 0xFFFFu) [[unlikely]]
+                return status::Error;
+            if (tx == nullptr and rx == nullptr) [[unlikely]]
+                return status::Error;
+
+            mBusy = true;
+            clock_busy();
+            mRxActive = RX_DMA_ENABLED and (rx != nullptr);
+            if (tx == nullptr) {
+                std::fill_n(rx, size, static_cast<data_type>(~data_type{0}));
+                tx = rx;
+            }
+            if (mRxActive) {
+                (void)kernel::ReadData();
+                mRxDMA.Start(kernel::DataRegisterAddress(), reinterpret_cast<uintptr_t>(rx), static_cast<uint16_t>(size));
+                kernel::RxDMA(ENABLED);
+            }
+            mTxDMA.Start(reinterpret_cast<uintptr_t>(tx), kernel::DataRegisterAddress(), static_cast<uint16_t>(size));
+            kernel::TxDMA(ENABLED);
+            return status::OK;
+        }
+        void end_tx_dma_transfer() noexcept
+        {
+            // Receiving transfers finish on the RX channel, once the last frame is in memory
+            if (not mRxActive)
+                end_dma_transfer();
+        }
+        void end_dma_transfer() noexcept
+        {
+            bool crc_error = false;
+            bool drained = true;
+
+            if constexpr (CRC_ENABLED) {
+                // TX DMA appends the CRC automatically; the received CRC is left in DR
+                if (mRxActive) {
+                    drained = drain<flag::RXNE>(ENABLED);
+                    (void)kernel::ReadData();
+                }
+            }
+            drained = drained and drain<flag::TXE>(ENABLED) and drain<flag::BSY>(DISABLED);
+            kernel::TxDMA(DISABLED);
+            kernel::RxDMA(DISABLED);
+
+            if (not mRxActive)
+                kernel::template ClearFlag<flag::OVR>();
+
+            if constexpr (CRC_ENABLED) {
+                crc_error = kernel::template FlagState<flag::CRCERR>();
+                kernel::template ClearFlag<flag::CRCERR>();
+                kernel::ResetCrc();
+            }
+            mBusy = false;
+            clock_idle();
+            (crc_error or not drained) ? TransferError() : TransferComplete();
+        }
+        template <flag tFLAG>
+        static bool drain(state const state) noexcept
+        {
+            for (uint32_t polls = DRAIN_POLLS; polls; --polls) {
+                if (kernel::template FlagState<tFLAG>() == state)
+                    return true;
+            }
+            return false;
+        }
         template <flag tFLAG>
         status wait_for_flag_state(state const state, system::timer& watch_dog) noexcept
         {
@@ -246,8 +466,13 @@ namespace hal::spi {
         }
 
     private:
+        [[no_unique_address]] rx_dma mRxDMA;
+        [[no_unique_address]] tx_dma mTxDMA;
+
         volatile bool mBusy = false;
+        bool mRxActive = false;
         payload_buffer mTxData;
         payload_buffer mRxData;
+        uint32_t mSckLimit = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+
+#include "utils/utility.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc/rcc.hpp"
+#include "dma/dma.hpp"
+#include "gpio/gpio.hpp"
+
+#include "spi.hpp"
+
+namespace hal::spi {
+
+    ////////////////////////////////
+    // Specifications
+    ////////////////////////////////
+    struct bus_specification {
+        peripheral const Peripheral;
+        data_width const DataWidth = data_width::_8bit;
+        size_t const QueueSize = 8;
+    };
+
+    struct device_specification {
+        gpio::port const SelectPort;
+        gpio::pin const SelectPin;
+        bit_order const BitOrder = bit_order::MSB;
+        clock_polarity const ClockPolarity = clock_polarity::Low;
+        clock_phase const ClockPhase = clock_phase::LeadingEdge;
+        clock_prescaler const ClockPrescaler = clock_prescaler::Div2;
+    };
+
+    ////////////////////////////////
+    // Bus
+    ////////////////////////////////
+    // Master-mode SPI peripheral shared by several chip-select devices. Transactions are queued
+    // and chained from the DMA completion ISR; CR1 is only rewritten when the device changes.
+    template <bus_specification tSPEC>
+    requires (tSPEC.QueueSize >= 2 and (tSPEC.QueueSize & (tSPEC.QueueSize - 1)) == 0)
+    class bus
+        : private rcc::clock_handler<details::PCLKn<tSPEC.Peripheral>>
+    {
+        using kernel = spi::kernel<tSPEC.Peripheral>;
+        using pclk = rcc::clock_handler<details::PCLKn<tSPEC.Peripheral>>;
+        using sclk_pin = gpio::module<details::sclkPinSpec<tSPEC.Peripheral>>;
+        using miso_pin = gpio::module<details::misoPinSpec<tSPEC.Peripheral>>;
+        using mosi_pin = gpio::module<details::mosiPinSpec<tSPEC.Peripheral>>;
+        using rx_dma = dma::module<details::RxDMA_Spec<tSPEC.Peripheral, tSPEC.DataWidth>>;
+        using tx_dma = dma::module<details::TxDMA_Spec<tSPEC.Peripheral, tSPEC.DataWidth>>;
+
+        static constexpr size_t MASK = tSPEC.QueueSize - 1;
+
+        // Same bound as spi::module: the drain runs in the DMA ISR, where the tick may not advance
+        static constexpr uint32_t DRAIN_POLLS = 2u * 16u * 256u * 2u;
+
+    public:
+        static constexpr auto DataWidth = tSPEC.DataWidth;
+        static constexpr std::array DmaChannels{ details::RxDMA_Channel<tSPEC.Peripheral>, details::TxDMA_Channel<tSPEC.Peripheral> };
+
+        using data_type = std::conditional_t<tSPEC.DataWidth == data_width::_8bit, uint8_t, uint16_t>;
+
+        struct transaction {
+            // Filled by the device
+            uint16_t Control;
+            uint32_t SelectAddress;
+            uint32_t SelectMask;
+            // Filled by the caller
+            data_type const* TxData;
+            data_type* RxData;
+            uint16_t Size;
+            bool HoldSelect;
+            callback Complete;
+            // Called instead of Complete when the bus failed to drain
+            callback Error;
+        };
+
+    public:
+        bus() noexcept
+            : pclk()
+        {
+            mRxDMA.TransferComplete.template Set<bus, &bus::rx_complete>(*this);
+            mTxDMA.TransferComplete.template Set<bus, &bus::tx_complete>(*this);
+
+            kernel::Configure(mode::Master, tSPEC.DataWidth, slave_management::SoftwareSelected);
+            mControl = kernel::Control();
+        }
+        ~bus() noexcept { kernel::State(DISABLED); }
+
+        // Queue a transaction; starts it immediately when the bus is idle.
+        status Submit(transaction const& xfer) noexcept
+        {
+            if (xfer.Size == 0 or (xfer.TxData == nullptr and xfer.RxData == nullptr)) [[unlikely]]
+                return status::Error;
+
+            // Claiming the slot and publishing it must not interleave with another producer,
+            // whether a second thread or an ISR submitting from a completion callback
+            bool start = false;
+            {
+                system::critical_section lock;
+                size_t const head = mHead;
+                if (((head + 1) & MASK) == mTail) [[unlikely]]
+                    return status::Busy;
+
+                mQueue[head] = xfer;
+                mHead = (head + 1) & MASK;
+
+                if (not mBusy) {
+                    mBusy = true;
+                    start = true;
+                }
+            }
+            if (start)
+                start_next();
+
+            return status::OK;
+        }
+        [[nodiscard]] bool IsBusy() const noexcept { return mBusy; }
+        [[nodiscard]] size_t Pending() const noexcept { return (mHead - mTail) & MASK; }
+
+    private:
+        void start_next() noexcept
+        {
+            transaction& xfer = mQueue[mTail];
+
+            if (xfer.Control != mControl) {
+                kernel::Control(static_cast<uint16_t>(xfer.Control & ~SPI_CR1_SPE));
+                kernel::Control(xfer.Control);
+                mControl = xfer.Control;
+            }
+            *reinterpret_cast<uint32_t volatile*>(xfer.SelectAddress) = xfer.SelectMask << 16u;
+
+            data_type const* tx = xfer.TxData;
+            if (tx == nullptr) {
+                std::fill_n(xfer.RxData, xfer.Size, static_cast<data_type>(~data_type{0}));
+                tx = xfer.RxData;
+            }
+            if (xfer.RxData != nullptr) {
+                (void)kernel::ReadData();
+                mRxDMA.Start(kernel::DataRegisterAddress(), reinterpret_cast<uintptr_t>(xfer.RxData), xfer.Size);
+                kernel::RxDMA(ENABLED);
+            }
+            mTxDMA.Start(reinterpret_cast<uintptr_t>(tx), kernel::DataRegisterAddress(), xfer.Size);
+            kernel::TxDMA(ENABLED);
+        }
+        void tx_complete() noexcept
+        {
+            // Receiving transactions complete on the RX channel, after the last frame is in memory
+            if (mQueue[mTail].RxData == nullptr)
+                end_transaction();
+        }
+        void rx_complete() noexcept { end_transaction(); }
+        void end_transaction() noexcept
+        {
+            bool const drained = drain<flag::TXE>(ENABLED) and drain<flag::BSY>(DISABLED);
+            kernel::TxDMA(DISABLED);
+            kernel::RxDMA(DISABLED);
+            kernel::template ClearFlag<flag::OVR>();
+
+            transaction const& xfer = mQueue[mTail];
+            if (not xfer.HoldSelect)
+                *reinterpret_cast<uint32_t volatile*>(xfer.SelectAddress) = xfer.SelectMask;
+
+            callback const done = drained ? xfer.Complete : xfer.Error;
+            mTail = (mTail + 1) & MASK;
+
+            if (mTail != mHead)
+                start_next();
+            else
+                mBusy = false;
+
+            done();
+        }
+        template <flag tFLAG>
+        static bool drain(state const state) noexcept
+        {
+            for (uint32_t polls = DRAIN_POLLS; polls; --polls) {
+                if (kernel::template FlagState<tFLAG>() == state)
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        sclk_pin mSCLK;
+        miso_pin mMISO;
+        mosi_pin mMOSI;
+        rx_dma mRxDMA;
+        tx_dma mTxDMA;
+
+        uint16_t mControl = 0;
+        bool volatile mBusy = false;
+        size_t volatile mHead = 0;
+        size_t volatile mTail = 0;
+        transaction mQueue[tSPEC.QueueSize]{};
+    };
+
+    ////////////////////////////////
+    // Device
+    ////////////////////////////////
+    template <typename tBUS, device_specification tSPEC>
+    class device {
+        static constexpr auto SelectPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = tSPEC.SelectPort,
+            .Pin = tSPEC.SelectPin,
+            .OutputMode = gpio::output_mode::GP_PushPull,
+            .OutputSpeed = gpio::output_speed::_50MHz
+        };
+        using select_pin = gpio::module<SelectPinSpec>;
+
+    public:
+        using data_type = typename tBUS::data_type;
+        using transaction = typename tBUS::transaction;
+
+        // Complete CR1 image for this device, written in one store when the bus switches to it
+        static constexpr uint16_t Control =
+              SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | SPI_CR1_SPE
+            | (EnumValue(tSPEC.ClockPrescaler) << SPI_CR1_BR_Pos)
+            | (tSPEC.ClockPolarity == clock_polarity::High ? SPI_CR1_CPOL : 0u)
+            | (tSPEC.ClockPhase == clock_phase::TrailingEdge ? SPI_CR1_CPHA : 0u)
+            | (tSPEC.BitOrder == bit_order::LSB ? SPI_CR1_LSBFIRST : 0u)
+            | (tBUS::DataWidth == data_width::_16bit ? SPI_CR1_DFF : 0u);
+
+    public:
+        explicit device(tBUS& bus) noexcept
+            : mBus(bus)
+            , mSelect(gpio::pin_state::High)
+        {}
+
+        // rx may be null (transmit only); tx may be null to clock out all-ones while reading.
+        // error replaces complete when the bus fails to drain at the end of the transfer.
+        status Transfer(data_type const* tx, data_type* rx, uint16_t const size, callback const& complete = {}, bool const hold_select = false, callback const& error = {}) noexcept
+        {
+            return mBus.Submit(transaction {
+                .Control = Control,
+                .SelectAddress = gpio::registers<tSPEC.SelectPort, tSPEC.SelectPin>::bsrr::REG.Address,
+                .SelectMask = 1u << EnumValue(tSPEC.SelectPin),
+                .TxData = tx,
+                .RxData = rx,
+                .Size = size,
+                .HoldSelect = hold_select,
+                .Complete = complete,
+                .Error = error
+            });
+        }
+        status Write(data_type const* tx, uint16_t const size, callback const& complete = {}, bool const hold_select = false, callback const& error = {}) noexcept
+        {
+            return Transfer(tx, nullptr, size, complete, hold_select, error);
+        }
+        status Read(data_type* rx, uint16_t const size, callback const& complete = {}, bool const hold_select = false, callback const& error = {}) noexcept
+        {
+            return Transfer(nullptr, rx, size, complete, hold_select, error);
+        }
+
+    private:
+        tBUS& mBus;
+        select_pin mSelect;
+    };
+}
@@ -64,6 +64,14 @@ namespace hal::spi {
         ,Div128 = 0b110
         ,Div256 = 0b111
     };
+    enum class crc_polynomial :uint16_t {
+        // CRC width follows the frame width: 8-bit frames compute CRC-8, 16-bit frames CRC-16
+         None = 0
+        ,CRC8 = 0x0007
+        ,CRC8_Dallas = 0x0031
+        ,CRC16_CCITT = 0x1021
+        ,CRC16_IBM = 0x8005
+    };
 
     template <typename T>
     concept cValidProperty =
@@ -74,7 +82,8 @@ namespace hal::spi {
         or std::same_as<std::remove_cvref_t<T>, slave_management>
         or std::same_as<std::remove_cvref_t<T>, clock_polarity>
         or std::same_as<std::remove_cvref_t<T>, clock_phase>
-        or std::same_as<std::remove_cvref_t<T>, clock_prescaler>;
+        or std::same_as<std::remove_cvref_t<T>, clock_prescaler>
+        or std::same_as<std::remove_cvref_t<T>, crc_polynomial>;
 
     ////////////////////////////////
     // Kernel
@@ -113,8 +122,37 @@ namespace hal::spi {
             if (select == slave_management::SoftwareSelected)
                 CR1::SSI.Set();
         }
+        static void SetProperty(crc_polynomial const polynomial) noexcept
+        {
+            // CRCEN may only change while SPE is cleared
+            if (polynomial == crc_polynomial::None) {
+                CR1::CRCEN.Reset();
+            }
+            else {
+                CRCPR::CRCPOLY.Write(EnumValue(polynomial));
+                CR1::CRCEN.Set();
+            }
+        }
         static void Configure(cValidProperty auto... setting) noexcept { ( SetProperty(setting), ... ); }
         static void SlaveSelectState(state const state) noexcept { CR1::SSI.Write(state); }
+        static void Control(uint16_t const control) noexcept { CR1::REG.Write(control); }
+        [[nodiscard]] static uint16_t Control() noexcept { return CR1::REG.Read(); }
+        static void TxDMA(state const state) noexcept { CR2::TXDMAEN.Write(state); }
+        [[nodiscard]] static state TxDMA() noexcept { return static_cast<state>(CR2::TXDMAEN.Read()); }
+        static void RxDMA(state const state) noexcept { CR2::RXDMAEN.Write(state); }
+        [[nodiscard]] static state RxDMA() noexcept { return static_cast<state>(CR2::RXDMAEN.Read()); }
+        static void CrcNext() noexcept { CR1::CRCNEXT.Set(); }
+        static void ResetCrc() noexcept
+        {
+            // Clearing CRCEN resets RXCRCR/TXCRCR; only legal while the peripheral is disabled
+            CR1::SPE.Reset();
+            CR1::CRCEN.Reset();
+            CR1::CRCEN.Set();
+            CR1::SPE.Set();
+        }
+        [[nodiscard]] static uint16_t RxCrc() noexcept { return RXCRCR::RXCRC.Read(); }
+        [[nodiscard]] static uint16_t TxCrc() noexcept { return TXCRCR::TXCRC.Read(); }
+        static constexpr uint32_t DataRegisterAddress() noexcept { return DR::REG.Address; }
         template <interrupt tInterrupt>
         [[nodiscard]] static state InterruptState() noexcept
         {
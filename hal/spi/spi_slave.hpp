@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "utils/utility.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc/rcc.hpp"
+#include "dma/dma.hpp"
+#include "gpio/gpio.hpp"
+
+#include "spi.hpp"
+
+namespace hal::spi {
+
+    namespace details {
+        template <peripheral tPeriph>
+        static constexpr auto SlavePort = (tPeriph == peripheral::SPI_1) ? gpio::port::A : gpio::port::B;
+
+        template <peripheral tPeriph, gpio::pin tPIN>
+        static constexpr auto SlaveInputSpec = gpio::specification<gpio::pin_type::Input> {
+            .Port = SlavePort<tPeriph>,
+            .Pin = tPIN,
+            .InputMode = gpio::input_mode::Floating
+        };
+        template <peripheral tPeriph>
+        static constexpr auto nssPinSpec = gpio::specification<gpio::pin_type::ExtInterrupt> {
+            .Port = SlavePort<tPeriph>,
+            .Pin = (tPeriph == peripheral::SPI_1) ? gpio::pin::_4 : gpio::pin::_12,
+            .InputMode = gpio::input_mode::PullUp
+        };
+        template <peripheral tPeriph>
+        static constexpr auto SlaveSclkPin = (tPeriph == peripheral::SPI_1) ? gpio::pin::_5 : gpio::pin::_13;
+        template <peripheral tPeriph>
+        static constexpr auto SlaveMosiPin = (tPeriph == peripheral::SPI_1) ? gpio::pin::_7 : gpio::pin::_15;
+    }
+
+    ////////////////////////////////
+    // Slave Specification
+    ////////////////////////////////
+    struct slave_specification {
+        peripheral const Peripheral;
+        data_width const DataWidth = data_width::_8bit;
+        bit_order const BitOrder = bit_order::MSB;
+        clock_polarity const ClockPolarity = clock_polarity::Low;
+        clock_phase const ClockPhase = clock_phase::LeadingEdge;
+        size_t const RxBufferSize = 256;
+    };
+
+    ////////////////////////////////
+    // Slave
+    ////////////////////////////////
+    // SPI slave with hardware NSS. Received frames land in a circular DMA ring and are framed by
+    // NSS edges (EXTI on the NSS pin); the transmit buffer is preloaded into TX DMA before the host
+    // selects us. Each transaction is reported once, on the NSS rising edge.
+    template <slave_specification tSPEC>
+    requires (tSPEC.RxBufferSize >= 2 and tSPEC.RxBufferSize <= 0xFFFF)
+    class slave
+        : private rcc::clock_handler<details::PCLKn<tSPEC.Peripheral>>
+    {
+        using kernel = spi::kernel<tSPEC.Peripheral>;
+        using rx_kernel = dma::kernel<details::RxDMA_Channel<tSPEC.Peripheral>>;
+        using pclk = rcc::clock_handler<details::PCLKn<tSPEC.Peripheral>>;
+
+        static constexpr auto RxSpec = dma::specification {
+            .Channel = details::RxDMA_Channel<tSPEC.Peripheral>,
+            .Direction = dma::direction::PeripheralToMemory,
+            .Increment = dma::increment::Memory,
+            .MemoryDataAlignment = (tSPEC.DataWidth == data_width::_8bit) ? dma::memory_alignment::Byte : dma::memory_alignment::HalfWord,
+            .PeripheralDataAlignment = (tSPEC.DataWidth == data_width::_8bit) ? dma::peripheral_alignment::Byte : dma::peripheral_alignment::HalfWord,
+            .Mode = dma::mode::Circular,
+            .Priority = dma::priority::VeryHigh
+        };
+        static constexpr auto MisoPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = details::SlavePort<tSPEC.Peripheral>,
+            .Pin = (tSPEC.Peripheral == peripheral::SPI_1) ? gpio::pin::_6 : gpio::pin::_14,
+            .OutputMode = gpio::output_mode::AF_PushPull,
+            .OutputSpeed = gpio::output_speed::_50MHz
+        };
+
+        using sclk_pin = gpio::module<details::SlaveInputSpec<tSPEC.Peripheral, details::SlaveSclkPin<tSPEC.Peripheral>>>;
+        using mosi_pin = gpio::module<details::SlaveInputSpec<tSPEC.Peripheral, details::SlaveMosiPin<tSPEC.Peripheral>>>;
+        using miso_pin = gpio::module<MisoPinSpec>;
+        using nss_pin = gpio::module<details::nssPinSpec<tSPEC.Peripheral>>;
+        using rx_dma = dma::module<RxSpec>;
+        using tx_dma = dma::module<details::TxDMA_Spec<tSPEC.Peripheral, tSPEC.DataWidth>>;
+
+        static constexpr uint16_t RING = static_cast<uint16_t>(tSPEC.RxBufferSize);
+
+    public:
+        static constexpr std::array DmaChannels{ details::RxDMA_Channel<tSPEC.Peripheral>, details::TxDMA_Channel<tSPEC.Peripheral> };
+
+        using data_type = std::conditional_t<tSPEC.DataWidth == data_width::_8bit, uint8_t, uint16_t>;
+        using frame = std::span<data_type const>;
+
+        // A frame may wrap around the ring, in which case it arrives as two pieces
+        delegate<void(frame const, frame const)> FrameReceived;
+
+    public:
+        slave() noexcept
+            : pclk()
+            , mNSS(exti::mode::Off, exti::trigger::Both, callback::template Create<slave, &slave::nss_edge>(*this))
+        {
+            mRxDMA.TransferComplete.template Set<slave, &slave::rx_wrap>(*this);
+            configure();
+        }
+        ~slave() noexcept { Stop(); }
+
+        // Data shifted out in the next transaction; the buffer must stay valid until it is replaced.
+        void Preload(frame const data) noexcept
+        {
+            mTxData = data;
+            if (mRunning and not mSelected)
+                arm_tx();
+        }
+        void Start() noexcept
+        {
+            mRunning = true;
+            mRxDMA.Start(kernel::DataRegisterAddress(), reinterpret_cast<uintptr_t>(mRing), RING);
+            kernel::RxDMA(ENABLED);
+            arm_tx();
+            mNSS.ClearPending();
+            mNSS.SetMode(exti::mode::Interrupt);
+        }
+        void Stop() noexcept
+        {
+            mNSS.SetMode(exti::mode::Off);
+            mRunning = false;
+            kernel::RxDMA(DISABLED);
+            kernel::TxDMA(DISABLED);
+            mRxDMA.Abort();
+            mTxDMA.Abort();
+        }
+        [[nodiscard]] bool IsSelected() const noexcept { return mSelected; }
+        [[nodiscard]] uint32_t Overruns() const noexcept { return mOverruns; }
+
+    private:
+        void configure() noexcept
+        {
+            kernel::Configure(mode::Slave, tSPEC.DataWidth, tSPEC.BitOrder, slave_management::HardwareSelected
+                ,tSPEC.ClockPolarity, tSPEC.ClockPhase);
+            kernel::State(ENABLED);
+        }
+        void arm_tx() noexcept
+        {
+            kernel::TxDMA(DISABLED);
+            if (mTxData.empty()) {
+                mTxDMA.Abort();
+                return;
+            }
+            mTxDMA.Start(reinterpret_cast<uintptr_t>(mTxData.data()), kernel::DataRegisterAddress(), static_cast<uint16_t>(mTxData.size()));
+            kernel::TxDMA(ENABLED);
+        }
+        [[nodiscard]] uint16_t position() noexcept { return static_cast<uint16_t>(RING - mRxDMA.DataCounter()) % RING; }
+        // DMA wrap
+        void rx_wrap() noexcept { mLaps = mLaps + 1u; }
+        // Ring position with every wrap so far counted. The NSS EXTI may share the DMA priority
+        // (SPI2: EXTI15_10 and DMA channel 4 both at 2), so a wrap can still be pending when an edge
+        // is handled; its flag is consumed here and the DMA ISR then finds nothing to do
+        [[nodiscard]] uint16_t settle() noexcept
+        {
+            uint16_t current;
+            do {
+                if (rx_kernel::template FlagState<dma::flag::TransferComplete>()) {
+                    rx_kernel::template ClearFlag<dma::flag::TransferComplete>();
+                    mLaps = mLaps + 1u;
+                }
+                current = position();
+            } while (rx_kernel::template FlagState<dma::flag::TransferComplete>());
+            return current;
+        }
+        void nss_edge() noexcept
+        {
+            mNSS.ClearPending();
+            if (not mNSS) {
+                mSelected = true;
+                mStart = settle();
+                mLaps = 0;
+                return;
+            }
+            mSelected = false;
+            uint16_t const end = settle();
+            uint32_t const length = (mLaps * RING) + end - mStart;
+
+            if (length > RING or kernel::template FlagState<flag::OVR>()) {
+                mOverruns = mOverruns + 1u;
+            }
+            else if (length) {
+                if (mStart + length <= RING) {
+                    FrameReceived.CallIf(frame{ mRing + mStart, length }, frame{});
+                }
+                else {
+                    FrameReceived.CallIf(frame{ mRing + mStart, static_cast<size_t>(RING - mStart) }
+                        ,frame{ mRing, static_cast<size_t>(end) });
+                }
+            }
+            resync();
+        }
+        // A short transaction leaves a preloaded frame stuck in DR; only a peripheral reset drops it
+        void resync() noexcept
+        {
+            if (kernel::template FlagState<flag::TXE>() and not kernel::template FlagState<flag::OVR>()) {
+                arm_tx();
+                return;
+            }
+            kernel::RxDMA(DISABLED);
+            kernel::TxDMA(DISABLED);
+            pclk::Reset();
+            configure();
+            mRxDMA.Start(kernel::DataRegisterAddress(), reinterpret_cast<uintptr_t>(mRing), RING);
+            kernel::RxDMA(ENABLED);
+            arm_tx();
+        }
+
+    private:
+        sclk_pin mSCLK;
+        mosi_pin mMOSI;
+        miso_pin mMISO;
+        nss_pin mNSS;
+        rx_dma mRxDMA;
+        tx_dma mTxDMA;
+
+        frame mTxData;
+        bool volatile mRunning = false;
+        bool volatile mSelected = false;
+        uint16_t mStart = 0;
+        uint32_t volatile mLaps = 0;
+        uint32_t volatile mOverruns = 0;
+        data_type mRing[tSPEC.RxBufferSize];
+    };
+}
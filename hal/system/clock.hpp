@@ -1,7 +1,5 @@
 #pragma once
 
-//#include "stm32f1xx_ll_system.h"
-
 #include "rcc/rcc_kernel.hpp"
 #include "flash/flash_kernel.hpp"
 #include "utils/utility.hpp"
@@ -20,11 +18,174 @@ namespace hal::system {
         rcc::pclk2_prescaler const PCLK2_Prescaler = rcc::pclk2_prescaler::None;
         rcc::pclk1_prescaler const PCLK1_Prescaler = rcc::pclk1_prescaler::None;
         uint32_t const HSE_Frequency, LSE_Frequency;
+        rcc::adc_prescaler const ADC_Prescaler = rcc::adc_prescaler::Div8;
+        rcc::usb_prescaler const USB_Prescaler = rcc::usb_prescaler::Div1_5;
     };
 
+    ////////////////////////////////
+    // Clock request
+    ////////////////////////////////
+    // Constraints handed to the clock solver; it picks the fastest SYSCLK not above SYSCLK_Max
+    // that every limit allows, preferring the HSE when both oscillators reach the same speed.
+    struct clock_request {
+        uint32_t const SYSCLK_Max = 72_MHz;
+        // 0 when no crystal is fitted
+        uint32_t const HSE_Frequency = 0;
+        uint32_t const LSE_Frequency = 0;
+        // Requires a 48 MHz USB clock, i.e. a 48 or 72 MHz PLL fed by HSE_Frequency
+        bool const USB_Clock = false;
+        uint32_t const ADC_Max = 14_MHz;
+        uint32_t const PCLK1_Max = 36_MHz;
+        uint32_t const PCLK2_Max = 72_MHz;
+    };
+
+    namespace details {
+        struct clock_solution {
+            bool Found = false;
+            bool FromHSE = false;
+            uint32_t SYSCLK = 0;
+            rcc::hclk_source HCLK_Source = rcc::hclk_source::HSI;
+            rcc::pll_source PLL_Source = rcc::pll_source::HSI_Div2;
+            rcc::pll_multiplier PLL_Multiplier = rcc::pll_multiplier::x2;
+            uint32_t PCLK2_Shift = 0;
+            uint32_t PCLK1_Shift = 0;
+            rcc::adc_prescaler ADC_Prescaler = rcc::adc_prescaler::Div8;
+            rcc::usb_prescaler USB_Prescaler = rcc::usb_prescaler::Div1_5;
+        };
+
+        constexpr uint32_t BusShift(uint32_t const frequency, uint32_t const limit) noexcept
+        {
+            uint32_t shift = 0;
+            while (shift < 4u and (frequency >> shift) > limit)
+                ++shift;
+            return shift;
+        }
+        consteval clock_solution SolveClock(clock_request const request) noexcept
+        {
+            clock_solution best{};
+            auto consider = [&](uint32_t const sysclk, rcc::hclk_source const source, rcc::pll_source const pll_source, uint32_t const multiplier, bool const hse) {
+                if (sysclk > request.SYSCLK_Max or sysclk > 72_MHz)
+                    return;
+                if (source == rcc::hclk_source::PLL and sysclk < 16_MHz)
+                    return;
+
+                clock_solution candidate{ true, hse, sysclk, source, pll_source, static_cast<rcc::pll_multiplier>(multiplier - 2u) };
+                if (request.USB_Clock) {
+                    // The HSI is outside the USB tolerance, so the PLL must run from the crystal
+                    if (source != rcc::hclk_source::PLL or not hse)
+                        return;
+                    if (sysclk == 48_MHz) candidate.USB_Prescaler = rcc::usb_prescaler::Div1;
+                    else if (sysclk == 72_MHz) candidate.USB_Prescaler = rcc::usb_prescaler::Div1_5;
+                    else return;
+                }
+                candidate.PCLK2_Shift = BusShift(sysclk, request.PCLK2_Max);
+                candidate.PCLK1_Shift = BusShift(sysclk, request.PCLK1_Max);
+                if ((sysclk >> candidate.PCLK2_Shift) > request.PCLK2_Max or (sysclk >> candidate.PCLK1_Shift) > request.PCLK1_Max)
+                    return;
+
+                uint32_t const pclk2 = sysclk >> candidate.PCLK2_Shift;
+                uint32_t divider = 2;
+                while (divider <= 8u and (pclk2 / divider) > request.ADC_Max)
+                    divider += 2;
+                if (divider > 8u)
+                    return;
+                candidate.ADC_Prescaler = static_cast<rcc::adc_prescaler>((divider / 2u) - 1u);
+
+                if (not best.Found or sysclk > best.SYSCLK or (sysclk == best.SYSCLK and hse and not best.FromHSE))
+                    best = candidate;
+            };
+
+            consider(HSI_VALUE, rcc::hclk_source::HSI, rcc::pll_source::HSI_Div2, 2, false);
+            if (request.HSE_Frequency)
+                consider(request.HSE_Frequency, rcc::hclk_source::HSE, rcc::pll_source::HSE, 2, true);
+            for (uint32_t multiplier = 2; multiplier <= 16u; ++multiplier) {
+                consider((HSI_VALUE / 2u) * multiplier, rcc::hclk_source::PLL, rcc::pll_source::HSI_Div2, multiplier, false);
+                if (request.HSE_Frequency) {
+                    consider(request.HSE_Frequency * multiplier, rcc::hclk_source::PLL, rcc::pll_source::HSE, multiplier, true);
+                    consider((request.HSE_Frequency / 2u) * multiplier, rcc::hclk_source::PLL, rcc::pll_source::HSE_Div2, multiplier, true);
+                }
+            }
+            return best;
+        }
+        consteval rcc::pclk2_prescaler Pclk2Prescaler(uint32_t const shift) noexcept
+        {
+            return shift ? static_cast<rcc::pclk2_prescaler>(0b011u + shift) : rcc::pclk2_prescaler::None;
+        }
+        consteval rcc::pclk1_prescaler Pclk1Prescaler(uint32_t const shift) noexcept
+        {
+            return shift ? static_cast<rcc::pclk1_prescaler>(0b011u + shift) : rcc::pclk1_prescaler::None;
+        }
+    }
+
+    template <clock_request tREQUEST>
+    struct clock_solver {
+        static constexpr auto Solution = details::SolveClock(tREQUEST);
+        static_assert(Solution.Found, "No clock configuration satisfies the request");
+
+        static constexpr auto Specification = clock_specification {
+            .HCLK_Source = Solution.HCLK_Source,
+            .PLL_Source = Solution.PLL_Source,
+            .PLL_Multiplier = Solution.PLL_Multiplier,
+            .HCLK_Prescaler = rcc::hclk_prescaler::None,
+            .PCLK2_Prescaler = details::Pclk2Prescaler(Solution.PCLK2_Shift),
+            .PCLK1_Prescaler = details::Pclk1Prescaler(Solution.PCLK1_Shift),
+            .HSE_Frequency = tREQUEST.HSE_Frequency,
+            .LSE_Frequency = tREQUEST.LSE_Frequency,
+            .ADC_Prescaler = Solution.ADC_Prescaler,
+            .USB_Prescaler = Solution.USB_Prescaler
+        };
+    };
+
+    ////////////////////////////////
+    // Runtime profile
+    ////////////////////////////////
+    // Bus frequencies of the configuration in use; the timer kernel clocks run at twice PCLKx
+    // whenever the APB prescaler divides
+    struct clock_frequencies {
+        uint32_t SYSCLK = HSI_VALUE;
+        uint32_t HCLK = HSI_VALUE;
+        uint32_t PCLK2 = HSI_VALUE;
+        uint32_t PCLK1 = HSI_VALUE;
+        uint32_t TIMCLK2 = HSI_VALUE;
+        uint32_t TIMCLK1 = HSI_VALUE;
+
+        bool operator==(clock_frequencies const&) const = default;
+    };
+    // Register image of a clock_specification, applied at run time by system::clock_scaling;
+    // the defaults describe the reset state
+    struct clock_profile {
+        rcc::hclk_source HCLK_Source = rcc::hclk_source::HSI;
+        rcc::pll_source PLL_Source = rcc::pll_source::HSI_Div2;
+        rcc::pll_multiplier PLL_Multiplier = rcc::pll_multiplier::x2;
+        rcc::hclk_prescaler HCLK_Prescaler = rcc::hclk_prescaler::None;
+        rcc::pclk2_prescaler PCLK2_Prescaler = rcc::pclk2_prescaler::None;
+        rcc::pclk1_prescaler PCLK1_Prescaler = rcc::pclk1_prescaler::None;
+        rcc::adc_prescaler ADC_Prescaler = rcc::adc_prescaler::Div2;
+        rcc::usb_prescaler USB_Prescaler = rcc::usb_prescaler::Div1_5;
+        uint32_t Latency = 0;
+        bool HalfCycle = false;
+        clock_frequencies Frequencies{};
+
+        bool operator==(clock_profile const&) const = default;
+    };
+
+    inline static clock_profile gClockProfile{};
+    // Nominal profile frequencies, corrected by the measured HSI when SYSCLK derives from it
+    inline static clock_frequencies gClockFrequencies{};
+    // Frequencies drivers time themselves against, kept current by system::clock and system::clock_scaling
+    [[nodiscard]] inline clock_frequencies const& ActiveClock() noexcept { return gClockFrequencies; }
+
     ////////////////////////////////
     // module
     ////////////////////////////////
+    template <clock_specification tSPEC>
+    struct clock;
+
+    // Clock built from solved constraints, e.g.
+    //     system::solved_clock<system::clock_request{ .HSE_Frequency = 8_MHz, .USB_Clock = true }> clk;
+    template <clock_request tREQUEST>
+    using solved_clock = clock<clock_solver<tREQUEST>::Specification>;
+
     template <clock_specification tSPEC>
     struct clock {
     private:
@@ -91,44 +252,86 @@ namespace hal::system {
         clock() noexcept
         {
             if (not gBusInitialized) {
-                flash::kernel::SetLatency(0);
+                // Wait states go up before the clock does and come down after it
+                bool const raising = LATENCY >= flash::kernel::GetLantency();
+                if (raising)
+                    flash::kernel::SetLatency(LATENCY);
                 flash::kernel::PrefetchState(ENABLED);
-                //LL_FLASH_SetLatency(LL_FLASH_LATENCY_0);
-                //while (LL_FLASH_GetLatency() != LL_FLASH_LATENCY_0); 
-
-                //LL_FLASH_EnablePrefetch();
+                flash::kernel::HalfCycleState(HALF_CYCLE ? ENABLED : DISABLED);
                 __NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
 
                 rcc::kernel::SourceClockState<hclkSource>(ENABLED);
-                if constexpr (tSPEC.HCLK_Source == rcc::hclk_source::HSI) {
-                    rcc::kernel::Configure(tSPEC.PLL_Source, tSPEC.PLL_Multiplier);
+                if constexpr (tSPEC.HCLK_Source == rcc::hclk_source::PLL) {
+                    rcc::kernel::Configure(tSPEC.PLL_Source, tSPEC.PLL_Multiplier, tSPEC.USB_Prescaler);
                     rcc::kernel::SourceClockState<rcc::source_clock::PLL>(ENABLED);
                 }
                 rcc::kernel::Configure(
-                     tSPEC.HCLK_Source
-                    ,tSPEC.HCLK_Prescaler
+                     tSPEC.HCLK_Prescaler
                     ,tSPEC.PCLK2_Prescaler
                     ,tSPEC.PCLK1_Prescaler
+                    ,tSPEC.ADC_Prescaler
+                    ,tSPEC.HCLK_Source
                 );
+                if (not raising)
+                    flash::kernel::SetLatency(LATENCY);
                 SystemCoreClock = HCLK_Frequency;
+                gClockProfile = PROFILE;
+                gClockFrequencies = PROFILE.Frequencies;
                 gBusInitialized = true;
             }
         }
         ~clock() noexcept
         {
             rcc::kernel::SourceClockState<hclkSource>(DISABLED);
-            if constexpr (tSPEC.HCLK_Source == rcc::hclk_source::HSI)
+            if constexpr (tSPEC.HCLK_Source == rcc::hclk_source::PLL)
                 rcc::kernel::SourceClockState<rcc::source_clock::PLL>(DISABLED);
 
             SystemCoreClock = HSI_VALUE;
+            gClockProfile = clock_profile{};
+            gClockFrequencies = clock_frequencies{};
             gBusInitialized = false;
         }
         
     public:
+        static constexpr uint32_t SYSCLK_Frequency = hclkSourceFrequency;
         static constexpr uint32_t HCLK_Frequency = hclkSourceFrequency >> hclkDivShift;
         static constexpr uint32_t PCLK2_Frequency = HCLK_Frequency >> pclk2DivShift;
         static constexpr uint32_t PCLK1_Frequency = HCLK_Frequency >> pclk1DivShift;
         static constexpr uint32_t PLL_Frequency = pllSourceFrequency * (EnumValue(tSPEC.PLL_Multiplier) + 2u);
+        static constexpr uint32_t ADC_Frequency = PCLK2_Frequency / ((EnumValue(tSPEC.ADC_Prescaler) + 1u) * 2u);
+        static constexpr uint32_t USB_Frequency = (tSPEC.USB_Prescaler == rcc::usb_prescaler::Div1) ? PLL_Frequency : (PLL_Frequency * 2u) / 3u;
+
+        static constexpr uint32_t LATENCY = flash::kernel::LatencyFor(SYSCLK_Frequency);
+        // Half-cycle flash access is only allowed below 8 MHz with an undivided HCLK
+        static constexpr bool HALF_CYCLE = SYSCLK_Frequency < 8_MHz and tSPEC.HCLK_Prescaler == rcc::hclk_prescaler::None;
+
+        static_assert(SYSCLK_Frequency <= 72_MHz, "SYSCLK above 72 MHz");
+        static_assert(PCLK2_Frequency <= 72_MHz, "PCLK2 above 72 MHz");
+        static_assert(PCLK1_Frequency <= 36_MHz, "PCLK1 above 36 MHz");
+        static_assert(ADC_Frequency <= 14_MHz, "ADC clock above 14 MHz");
+        static_assert(hclkSource != rcc::source_clock::HSE or (tSPEC.HSE_Frequency >= 4_MHz and tSPEC.HSE_Frequency <= 16_MHz), "HSE must be 4 to 16 MHz");
+        static_assert(tSPEC.HCLK_Source != rcc::hclk_source::PLL or (PLL_Frequency >= 16_MHz and PLL_Frequency <= 72_MHz), "PLL output must be 16 to 72 MHz");
+
+        static constexpr clock_profile PROFILE = {
+            .HCLK_Source = tSPEC.HCLK_Source,
+            .PLL_Source = tSPEC.PLL_Source,
+            .PLL_Multiplier = tSPEC.PLL_Multiplier,
+            .HCLK_Prescaler = tSPEC.HCLK_Prescaler,
+            .PCLK2_Prescaler = tSPEC.PCLK2_Prescaler,
+            .PCLK1_Prescaler = tSPEC.PCLK1_Prescaler,
+            .ADC_Prescaler = tSPEC.ADC_Prescaler,
+            .USB_Prescaler = tSPEC.USB_Prescaler,
+            .Latency = LATENCY,
+            .HalfCycle = HALF_CYCLE,
+            .Frequencies = {
+                .SYSCLK = SYSCLK_Frequency,
+                .HCLK = HCLK_Frequency,
+                .PCLK2 = PCLK2_Frequency,
+                .PCLK1 = PCLK1_Frequency,
+                .TIMCLK2 = pclk2DivShift ? PCLK2_Frequency * 2u : PCLK2_Frequency,
+                .TIMCLK1 = pclk1DivShift ? PCLK1_Frequency * 2u : PCLK1_Frequency
+            }
+        };
 
         template <rcc::cPeripheralClock auto tPERIPH>
         static constexpr uint32_t PCLK_Frequency = []() consteval noexcept
@@ -139,4 +342,7 @@ namespace hal::system {
                 return PCLK1_Frequency;
         }();
     };
+
+    template <clock_specification tSPEC>
+    static constexpr clock_profile Profile = clock<tSPEC>::PROFILE;
 }
\ No newline at end of file
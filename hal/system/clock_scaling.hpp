@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "include/delegate.hpp"
+#include "utils/utility.hpp"
+
+#include "interrupt.hpp"
+#include "clock.hpp"
+
+namespace hal::system {
+
+    ////////////////////////////////
+    // Clock listener
+    ////////////////////////////////
+    // Keeps a re-timing handler registered for its lifetime. Drivers exposing
+    // Retime(clock_frequencies const&), such as usart::module, spi::module, tim::module and
+    // system::tick, are attached directly:
+    //     system::clock_listener uart_timing{ uart };
+    class clock_listener {
+    public:
+        using handler = delegate<void(clock_frequencies const&)>;
+
+    public:
+        clock_listener(clock_listener&&) = delete;
+        clock_listener(clock_listener const&) = delete;
+        clock_listener& operator=(clock_listener&&) = delete;
+        clock_listener& operator=(clock_listener const&) = delete;
+
+        explicit clock_listener(handler const& retime) noexcept
+            : mRetime(retime)
+        {
+            critical_section lock;
+            mNext = sHead;
+            sHead = this;
+        }
+        template <typename T>
+        requires requires (T& driver, clock_frequencies const& clocks) { driver.Retime(clocks); }
+        explicit clock_listener(T& driver) noexcept
+            : clock_listener(handler::template Create<T, &T::Retime>(driver))
+        {}
+        ~clock_listener() noexcept
+        {
+            critical_section lock;
+            for (clock_listener** link = &sHead; *link; link = &(*link)->mNext) {
+                if (*link == this) {
+                    *link = mNext;
+                    break;
+                }
+            }
+        }
+
+    private:
+        friend class clock_scaling;
+
+        inline static clock_listener* sHead = nullptr;
+        clock_listener* mNext = nullptr;
+        handler const mRetime;
+    };
+
+    ////////////////////////////////
+    // Clock scaling
+    ////////////////////////////////
+    // Switches between clock profiles at run time, e.g. full speed while active and the bare HSI
+    // while idle:
+    //     static constexpr auto Active = system::Profile<system::clock_solver<system::clock_request{ .HSE_Frequency = 8_MHz }>::Specification>;
+    //     static constexpr auto Idle = system::Profile<system::clock_specification{ .HSE_Frequency = 8_MHz, .LSE_Frequency = 0 }>;
+    //     system::clock_scaling::Switch(Idle);
+    //
+    // The switch runs with interrupts masked. Flash wait states go up first and come down last;
+    // SYSCLK parks on the HSI while the prescalers change and, when its settings differ, while the
+    // PLL re-locks, so no bus exceeds its limit at any point. Every clock_listener is re-timed
+    // before interrupts resume. A frame in flight across the switch is lost, so switch between
+    // transfers; USB stops while the PLL is off.
+    class clock_scaling {
+        [[nodiscard]] static bool uses_hse(clock_profile const& profile) noexcept
+        {
+            return profile.HCLK_Source == rcc::hclk_source::HSE
+                or (profile.HCLK_Source == rcc::hclk_source::PLL and profile.PLL_Source != rcc::pll_source::HSI_Div2);
+        }
+        [[nodiscard]] static bool uses_hsi(clock_profile const& profile) noexcept
+        {
+            return profile.HCLK_Source == rcc::hclk_source::HSI
+                or (profile.HCLK_Source == rcc::hclk_source::PLL and profile.PLL_Source == rcc::pll_source::HSI_Div2);
+        }
+        [[nodiscard]] static bool same_pll(clock_profile const& a, clock_profile const& b) noexcept
+        {
+            return a.HCLK_Source == rcc::hclk_source::PLL and b.HCLK_Source == rcc::hclk_source::PLL
+                and a.PLL_Source == b.PLL_Source and a.PLL_Multiplier == b.PLL_Multiplier and a.USB_Prescaler == b.USB_Prescaler;
+        }
+
+    public:
+        static void Switch(clock_profile const& profile) noexcept
+        {
+            critical_section lock;
+            clock_profile const current = gClockProfile;
+            if (profile == current)
+                return;
+
+            flash::kernel::HalfCycleState(DISABLED);
+            flash::kernel::SetLatency(std::max(current.Latency, profile.Latency));
+
+            rcc::kernel::SourceClockState<rcc::source_clock::HSI>(ENABLED);
+            rcc::kernel::SetProperty(rcc::hclk_source::HSI);
+
+            bool const keep_pll = same_pll(current, profile);
+            if (not keep_pll)
+                rcc::kernel::SourceClockState<rcc::source_clock::PLL>(DISABLED);
+            if (uses_hse(profile))
+                rcc::kernel::SourceClockState<rcc::source_clock::HSE>(ENABLED);
+            if (profile.HCLK_Source == rcc::hclk_source::PLL and not keep_pll) {
+                rcc::kernel::Configure(profile.PLL_Source, profile.PLL_Multiplier, profile.USB_Prescaler);
+                rcc::kernel::SourceClockState<rcc::source_clock::PLL>(ENABLED);
+            }
+            rcc::kernel::Configure(
+                 profile.HCLK_Prescaler
+                ,profile.PCLK2_Prescaler
+                ,profile.PCLK1_Prescaler
+                ,profile.ADC_Prescaler
+                ,profile.HCLK_Source
+            );
+
+            flash::kernel::SetLatency(profile.Latency);
+            flash::kernel::HalfCycleState(profile.HalfCycle ? ENABLED : DISABLED);
+            if (uses_hse(current) and not uses_hse(profile))
+                rcc::kernel::SourceClockState<rcc::source_clock::HSE>(DISABLED);
+
+            gClockProfile = profile;
+            publish();
+        }
+        // Records the HSI frequency measured by rcc::hsi_trimmer; while SYSCLK derives from the HSI
+        // the active frequencies follow it and every clock_listener is re-timed
+        static void Calibrate(uint32_t const hsi_frequency) noexcept
+        {
+            critical_section lock;
+            sHsiFrequency = hsi_frequency;
+            publish();
+        }
+        [[nodiscard]] static clock_profile const& Current() noexcept { return gClockProfile; }
+        [[nodiscard]] static bool FromHSI() noexcept { return uses_hsi(gClockProfile); }
+
+    private:
+        static void publish() noexcept
+        {
+            gClockFrequencies = gClockProfile.Frequencies;
+            if (uses_hsi(gClockProfile) and sHsiFrequency != HSI_VALUE) {
+                auto const scale = [](uint32_t const frequency) noexcept {
+                    return static_cast<uint32_t>((static_cast<uint64_t>(frequency) * sHsiFrequency) / HSI_VALUE);
+                };
+                gClockFrequencies = {
+                    .SYSCLK = scale(gClockFrequencies.SYSCLK),
+                    .HCLK = scale(gClockFrequencies.HCLK),
+                    .PCLK2 = scale(gClockFrequencies.PCLK2),
+                    .PCLK1 = scale(gClockFrequencies.PCLK1),
+                    .TIMCLK2 = scale(gClockFrequencies.TIMCLK2),
+                    .TIMCLK1 = scale(gClockFrequencies.TIMCLK1)
+                };
+            }
+            SystemCoreClock = gClockFrequencies.HCLK;
+            for (clock_listener* listener = clock_listener::sHead; listener; listener = listener->mNext)
+                listener->mRetime(gClockFrequencies);
+        }
+
+    private:
+        inline static uint32_t sHsiFrequency = HSI_VALUE;
+    };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "stm32f103xb.h"
+
+#include "utils/utility.hpp"
+
+namespace hal::system {
+
+    ////////////////////////////////
+    // Cycle Counter
+    ////////////////////////////////
+    // DWT CYCCNT, a free-running 32-bit HCLK counter. Wraps after ~59 s at 72 MHz, so differences of
+    // two samples are valid for anything shorter than that.
+    class cycle_counter {
+    public:
+        static void Enable() noexcept
+        {
+            CoreDebug->DEMCR = CoreDebug->DEMCR | CoreDebug_DEMCR_TRCENA_Msk;
+            DWT->CYCCNT = 0;
+            DWT->CTRL = DWT->CTRL | DWT_CTRL_CYCCNTENA_Msk;
+        }
+        [[nodiscard]] static bool IsEnabled() noexcept { return DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk; }
+        [[nodiscard]] INLINE static uint32_t Now() noexcept { return DWT->CYCCNT; }
+        // Cycles spent in fn, less the cost of the two counter reads
+        template <typename tFN>
+        [[nodiscard]] static uint32_t Measure(tFN&& fn) noexcept
+        {
+            uint32_t const overhead = calibrate();
+            uint32_t const start = Now();
+            std::forward<tFN>(fn)();
+            uint32_t const cycles = Now() - start;
+            return (cycles > overhead) ? (cycles - overhead) : 0;
+        }
+
+    private:
+        static uint32_t calibrate() noexcept
+        {
+            uint32_t const start = Now();
+            return Now() - start;
+        }
+    };
+}
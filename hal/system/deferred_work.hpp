@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "utils/utility.hpp"
+
+#include "interrupt.hpp"
+
+#include "exti/exti.hpp"
+
+namespace hal::system {
+
+    ////////////////////////////////
+    // Deferred Work Specification
+    ////////////////////////////////
+    struct deferred_specification {
+        // An EXTI line with its own NVIC vector and nothing else attached: 0..4 when the matching
+        // GPIO pin needs no interrupt, or 16..18 when PVD, RTC alarm and USB wakeup are unused
+        exti::line const Line;
+        uint8_t const Priority = 14;
+        size_t const QueueSize = 16;
+    };
+
+    ////////////////////////////////
+    // Deferred Work
+    ////////////////////////////////
+    // Bottom-half execution: high-priority ISRs Post() work items into a lock-free queue and raise
+    // the EXTI software interrupt of Line, whose handler runs the items at Priority once nothing
+    // more urgent is pending. Several levels are obtained with several lines.
+    //
+    //     system::deferred_work<system::deferred_specification{ .Line = exti::line::_16 }> bottom_half;
+    //     void dma_done() { bottom_half.Post(callback::Create<parser, &parser::run>(p)); }
+    template <deferred_specification tSPEC>
+    requires (exti::cUniqueIRQ<tSPEC.Line> and tSPEC.QueueSize > 1 and (tSPEC.QueueSize & (tSPEC.QueueSize - 1)) == 0)
+    class deferred_work
+        : private interrupt<exti::details::IRQn<tSPEC.Line>>
+    {
+        using irq = interrupt<exti::details::IRQn<tSPEC.Line>>;
+        using kernel = exti::kernel<tSPEC.Line>;
+
+        static constexpr uint32_t SIZE = tSPEC.QueueSize;
+        static constexpr uint32_t MASK = SIZE - 1;
+
+        // Bounded MPSC queue: each cell's sequence tells producers and the consumer whose turn it is
+        struct cell {
+            std::atomic<uint32_t> Sequence;
+            callback Work;
+        };
+
+    public:
+        deferred_work() noexcept
+            : irq(irq::callback::template Create<deferred_work, &deferred_work::drain>(*this), tSPEC.Priority)
+        {
+            for (uint32_t i = 0; i < SIZE; ++i)
+                mCells[i].Sequence.store(i, std::memory_order_relaxed);
+            kernel::Configure(exti::trigger::None, exti::mode::Interrupt);
+        }
+        ~deferred_work() noexcept
+        {
+            kernel::SetProperty(exti::mode::Off);
+            kernel::ClearPending();
+        }
+
+        // Safe from any ISR or thread context; returns false, counting a drop, when the queue is full
+        bool Post(callback const& work) noexcept
+        {
+            uint32_t position = mHead.load(std::memory_order_relaxed);
+            cell* target;
+            for (;;) {
+                target = &mCells[position & MASK];
+                int32_t const lag = static_cast<int32_t>(target->Sequence.load(std::memory_order_acquire) - position);
+                if (lag == 0) {
+                    if (mHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (lag < 0) {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else {
+                    position = mHead.load(std::memory_order_relaxed);
+                }
+            }
+            target->Work = work;
+            target->Sequence.store(position + 1, std::memory_order_release);
+            kernel::GenerateSWI();
+            return true;
+        }
+        [[nodiscard]] uint32_t Dropped() const noexcept { return mDropped.load(std::memory_order_relaxed); }
+
+    private:
+        // Runs every published item; a producer preempted mid-publish raises the SWI again itself
+        void drain() noexcept
+        {
+            kernel::ClearPending();
+            for (;;) {
+                cell& target = mCells[mTail & MASK];
+                if (target.Sequence.load(std::memory_order_acquire) != mTail + 1)
+                    break;
+
+                callback const work = target.Work;
+                target.Sequence.store(mTail + SIZE, std::memory_order_release);
+                mTail = mTail + 1;
+                work();
+            }
+        }
+
+    private:
+        cell mCells[SIZE];
+        std::atomic<uint32_t> mHead{ 0 };
+        uint32_t mTail = 0;
+        std::atomic<uint32_t> mDropped{ 0 };
+    };
+}
@@ -77,13 +77,39 @@ namespace hal::system {
     concept cValidIRQ = std::same_as<T, cortex_irq> or std::same_as<T, peripheral_irq>;
 
     ////////////////////////////////
-    // interrupt
+    // critical_section
+    ////////////////////////////////
+    // Masks all maskable interrupts for its lifetime and restores the previous PRIMASK on exit,
+    // so sections nest safely inside ISRs and other critical sections.
+    class critical_section {
+    public:
+        critical_section() noexcept
+            : mPrimask(__get_PRIMASK())
+        {
+            __disable_irq();
+        }
+        ~critical_section() noexcept { __set_PRIMASK(mPrimask); }
+
+    private:
+        critical_section(critical_section const&) = delete;
+        critical_section& operator=(critical_section const&) = delete;
+
+        uint32_t const mPrimask;
+    };
+
+    ////////////////////////////////
+    // interrupt_vector
     ////////////////////////////////
+    // Handler slot and NVIC controls of one IRQ, with no ownership. system::interrupt installs its
+    // handler for its lifetime; modules time-sharing a line (dma::module on an arbitrated channel)
+    // derive from this directly and install only while they own it.
     template <cValidIRQ auto tIRQ>
-    class interrupt {
+    class interrupt_vector {
         static constexpr auto IRQn = static_cast<IRQn_Type>(EnumValue(tIRQ));
 
     public:
+        // Stays in flash with the vector table and the delegate stub it calls: in SRAM it would
+        // only add a long-call veneer on the way in and another on the way out to the stub
         static void Dispatch() noexcept { Callback(); }
 
     protected:
@@ -91,18 +117,6 @@ namespace hal::system {
 
         inline static callback Callback;
 
-        interrupt(callback const& func, uint8_t const priority = 7_u8, state const initial = ENABLED) noexcept
-        {
-            Callback = func;
-            SetPriority(priority);
-            State(initial);
-        }
-        ~interrupt() noexcept
-        {
-            State(DISABLED);
-            Callback.Clear();
-        }
-
         static void State(state const state) noexcept
         {
             if constexpr (std::same_as<decltype(tIRQ), peripheral_irq>)
@@ -121,6 +135,34 @@ namespace hal::system {
                 );
             }
         }
+    };
+
+    ////////////////////////////////
+    // interrupt
+    ////////////////////////////////
+    template <cValidIRQ auto tIRQ>
+    class interrupt
+        : public interrupt_vector<tIRQ>
+    {
+        using vector = interrupt_vector<tIRQ>;
+
+    protected:
+        using typename vector::callback;
+        using vector::Callback;
+        using vector::State;
+        using vector::SetPriority;
+
+        interrupt(callback const& func, uint8_t const priority = 7_u8, state const initial = ENABLED) noexcept
+        {
+            Callback = func;
+            SetPriority(priority);
+            State(initial);
+        }
+        ~interrupt() noexcept
+        {
+            State(DISABLED);
+            Callback.Clear();
+        }
 
     private:
         interrupt(interrupt&&) = delete;
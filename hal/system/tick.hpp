@@ -5,6 +5,7 @@
 
 #include "utils/utility.hpp"
 
+#include "clock.hpp"
 #include "interrupt.hpp"
 
 #include "systick/systick_kernel.hpp"
@@ -26,13 +27,14 @@ namespace hal::system {
         tick& operator=(tick const&) = delete;
 
         tick(uint32_t const tick_frequency, uint32_t const hclk_frequency, systick::hclk_divider const divider) noexcept
-            : irq([]() noexcept { sTickCount.fetch_add(1, std::memory_order_relaxed); })
+            : irq(irq::callback::template Create<&tick::count>())
         {
             if (not sInitialized) {
                 systick::kernel::SetProperty(divider);
                 systick::kernel::TickFrequency(tick_frequency, hclk_frequency);
                 systick::kernel::InterruptState(ENABLED);
                 systick::kernel::State(ENABLED);
+                sTickFrequency = tick_frequency;
                 sInitialized = true;
             }
         }
@@ -50,9 +52,15 @@ namespace hal::system {
             sInitialized = false;
         }
         static uint32_t Ticks() noexcept { return sTickCount.load(std::memory_order_relaxed); }
+        // Reloads SysTick for the new HCLK so the tick period is unchanged (system::clock_listener)
+        void Retime(clock_frequencies const& clocks) noexcept { systick::kernel::TickFrequency(sTickFrequency, clocks.HCLK); }
+
+    private:
+        RAMFUNC static void count() noexcept { sTickCount.fetch_add(1, std::memory_order_relaxed); }
 
     private:
         inline static bool sInitialized = false;
+        inline static uint32_t sTickFrequency = 1_kHz;
         inline static std::atomic<uint32_t> sTickCount = 0;
     };
 
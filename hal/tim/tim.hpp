@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+
+#include "utils/utility.hpp"
+#include "system/clock.hpp"
+#include "system/interrupt.hpp"
+
+#include "rcc/rcc.hpp"
+#include "dma/dma_registers.hpp"
+
+#include "tim_kernel.hpp"
+
+namespace hal::tim {
+
+    namespace details {
+        template <peripheral tPERIPH>
+        static constexpr auto PCLK = []() consteval noexcept {
+            if constexpr (tPERIPH == peripheral::TIM_1) return rcc::pclk2::TIM_1;
+            else if constexpr (tPERIPH == peripheral::TIM_2) return rcc::pclk1::TIM_2;
+            else if constexpr (tPERIPH == peripheral::TIM_3) return rcc::pclk1::TIM_3;
+            else return rcc::pclk1::TIM_4;
+        }();
+        template <peripheral tPERIPH>
+        static constexpr auto IRQn = []() consteval noexcept {
+            switch (tPERIPH) {
+            case peripheral::TIM_2: return system::peripheral_irq::TIM_2;
+            case peripheral::TIM_3: return system::peripheral_irq::TIM_3;
+            case peripheral::TIM_4: return system::peripheral_irq::TIM_4;
+            default: return system::peripheral_irq::TIM_1_CC;
+            }
+        }();
+        // DMA1 channel serving the TIMx_UP request
+        template <peripheral tPERIPH>
+        static constexpr auto UpdateDMA_Channel = []() consteval noexcept {
+            if constexpr (tPERIPH == peripheral::TIM_1) return dma::channel::_5;
+            else if constexpr (tPERIPH == peripheral::TIM_2) return dma::channel::_2;
+            else if constexpr (tPERIPH == peripheral::TIM_3) return dma::channel::_3;
+            else return dma::channel::_7;
+        }();
+    }
+
+    ////////////////////////////////
+    // Specification
+    ////////////////////////////////
+    struct specification {
+        peripheral const Peripheral;
+        uint16_t const Prescaler = 0;
+        uint16_t const Period = 0xFFFF;
+        uint8_t const Priority = 2;
+    };
+
+    ////////////////////////////////
+    // Module
+    ////////////////////////////////
+    // General purpose timer (TIM2..TIM4). The counter free-runs from 0 to Period; each
+    // capture/compare channel has its own callback so independent users can share one timer.
+    template <specification tSPEC>
+    requires (tSPEC.Peripheral != peripheral::TIM_1)
+    class module
+        : private rcc::clock_handler<details::PCLK<tSPEC.Peripheral>>
+        , private system::interrupt<details::IRQn<tSPEC.Peripheral>>
+    {
+        using kernel = tim::kernel<tSPEC.Peripheral>;
+        using irq = system::interrupt<details::IRQn<tSPEC.Peripheral>>;
+        using pclk = rcc::clock_handler<details::PCLK<tSPEC.Peripheral>>;
+
+        template <channel tCHAN>
+        using channel_kernel = tim::channel_kernel<tSPEC.Peripheral, tCHAN>;
+
+    public:
+        callback Update;
+        callback CaptureCompare[4];
+
+    public:
+        module() noexcept
+            : pclk()
+            , irq(irq::callback::template Create<module, &module::isr>(*this), tSPEC.Priority)
+        {
+            kernel::SetPrescaler(tSPEC.Prescaler);
+            kernel::SetAutoReload(tSPEC.Period);
+            kernel::GenerateUpdate();
+            kernel::template ClearFlag<flag::Update>();
+            mTickRate = system::ActiveClock().TIMCLK1 / (tSPEC.Prescaler + 1u);
+        }
+        ~module() noexcept { kernel::State(DISABLED); }
+
+        void Start() noexcept { kernel::State(ENABLED); }
+        void Stop() noexcept { kernel::State(DISABLED); }
+        [[nodiscard]] uint16_t Counter() const noexcept { return kernel::Counter(); }
+        void UpdateInterrupt(state const state) noexcept
+        {
+            kernel::template ClearFlag<flag::Update>();
+            kernel::template InterruptState<interrupt::Update>(state);
+        }
+        // Update events raise the timer's TIMx_UP DMA request
+        void UpdateDMA(state const state) noexcept { kernel::UpdateDMA(state); }
+        void GenerateUpdate() noexcept { kernel::GenerateUpdate(); }
+        void Counter(uint16_t const count) noexcept { kernel::Counter(count); }
+        // Rescales the prescaler so the counter keeps its tick rate; it takes effect at the next
+        // update event (system::clock_listener)
+        void Retime(system::clock_frequencies const& clocks) noexcept
+        {
+            uint32_t const prescaler = (clocks.TIMCLK1 + (mTickRate / 2u)) / mTickRate;
+            kernel::SetPrescaler(static_cast<uint16_t>(std::clamp<uint32_t>(prescaler, 1u, 0x10000u) - 1u));
+        }
+
+        template <channel tCHAN>
+        void ConfigureChannel(cValidChannelProperty auto... property) noexcept { channel_kernel<tCHAN>::Configure(property...); }
+        template <channel tCHAN>
+        void Compare(uint16_t const value) noexcept { channel_kernel<tCHAN>::Compare(value); }
+        template <channel tCHAN>
+        [[nodiscard]] uint16_t Compare() const noexcept { return channel_kernel<tCHAN>::Compare(); }
+        template <channel tCHAN>
+        void ChannelInterrupt(state const state) noexcept
+        {
+            channel_kernel<tCHAN>::ClearFlag();
+            channel_kernel<tCHAN>::InterruptState(state);
+        }
+
+    private:
+        INLINE void isr() noexcept
+        {
+            uint32_t const pending = kernel::PendingInterrupts();
+            kernel::ClearPending(pending);
+
+            if (pending & TIM_SR_CC1IF) CaptureCompare[0]();
+            if (pending & TIM_SR_CC2IF) CaptureCompare[1]();
+            if (pending & TIM_SR_CC3IF) CaptureCompare[2]();
+            if (pending & TIM_SR_CC4IF) CaptureCompare[3]();
+            if (pending & TIM_SR_UIF) Update();
+        }
+
+    private:
+        uint32_t mTickRate = 0;
+    };
+}
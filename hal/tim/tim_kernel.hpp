@@ -0,0 +1,130 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+
+#include "tim_registers.hpp"
+
+namespace hal::tim {
+
+    enum class flag :uint8_t {
+         Update
+        ,Trigger
+    };
+    enum class interrupt :uint8_t {
+         Update
+        ,Trigger
+    };
+
+    ////////////////////////////////
+    // Properties
+    ////////////////////////////////
+    enum class compare_mode :uint8_t {
+         Frozen = 0b000
+        ,ActiveOnMatch = 0b001
+        ,InactiveOnMatch = 0b010
+        ,Toggle = 0b011
+        ,ForceInactive = 0b100
+        ,ForceActive = 0b101
+        ,PWM1 = 0b110
+        ,PWM2 = 0b111
+    };
+    enum class capture_select :uint8_t {
+         Output = 0b00
+        ,InputDirect = 0b01
+        ,InputIndirect = 0b10
+        ,InputTRC = 0b11
+    };
+    enum class polarity :bool {
+         ActiveHigh
+        ,ActiveLow
+    };
+
+    template <typename T>
+    concept cValidChannelProperty =
+           std::same_as<std::remove_cvref_t<T>, compare_mode>
+        or std::same_as<std::remove_cvref_t<T>, capture_select>
+        or std::same_as<std::remove_cvref_t<T>, polarity>;
+
+    ////////////////////////////////
+    // Kernel
+    ////////////////////////////////
+    template <peripheral tPERIPH>
+    class kernel {
+        using CR1 = registers<tPERIPH>::cr1;
+        using DIER = registers<tPERIPH>::dier;
+        using SR = registers<tPERIPH>::sr;
+        using EGR = registers<tPERIPH>::egr;
+        using CNT = registers<tPERIPH>::cnt;
+        using PSC = registers<tPERIPH>::psc;
+        using ARR = registers<tPERIPH>::arr;
+
+    public:
+        static void State(state const state) noexcept { CR1::CEN.Write(state); }
+        [[nodiscard]] static state State() noexcept { return static_cast<state>(CR1::CEN.Read()); }
+        static void SetPrescaler(uint16_t const prescaler) noexcept { PSC::PSC.Write(prescaler); }
+        static void SetAutoReload(uint16_t const period) noexcept { ARR::ARR.Write(period); }
+        static void Counter(uint16_t const count) noexcept { CNT::CNT.Write(count); }
+        [[nodiscard]] static uint16_t Counter() noexcept { return CNT::CNT.Read(); }
+        static void GenerateUpdate() noexcept { EGR::REG.Write(TIM_EGR_UG); }
+        static void UpdateDMA(state const state) noexcept { DIER::UDE.Write(state); }
+        template <interrupt tIT>
+        static void InterruptState(state const state) noexcept
+        {
+            if constexpr (tIT == interrupt::Update) { DIER::UIE.Write(state); }
+            else if constexpr (tIT == interrupt::Trigger) { DIER::TIE.Write(state); }
+        }
+        template <interrupt tIT>
+        [[nodiscard]] static state InterruptState() noexcept
+        {
+            if constexpr (tIT == interrupt::Update) { return static_cast<state>(DIER::UIE.Read()); }
+            else if constexpr (tIT == interrupt::Trigger) { return static_cast<state>(DIER::TIE.Read()); }
+        }
+        template <flag tFLAG>
+        [[nodiscard]] static state FlagState() noexcept
+        {
+            if constexpr (tFLAG == flag::Update) { return static_cast<state>(SR::UIF.Read()); }
+            else if constexpr (tFLAG == flag::Trigger) { return static_cast<state>(SR::TIF.Read()); }
+        }
+        template <flag tFLAG>
+        static void ClearFlag() noexcept
+        {
+            // SR flags are rc_w0: writing the complement clears only the requested flag
+            if constexpr (tFLAG == flag::Update) { SR::REG.Write(~TIM_SR_UIF); }
+            else if constexpr (tFLAG == flag::Trigger) { SR::REG.Write(~TIM_SR_TIF); }
+        }
+        [[nodiscard]] static uint32_t PendingInterrupts() noexcept
+        {
+            return SR::REG.Read() & DIER::REG.Read() & (TIM_SR_UIF | TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF | TIM_SR_TIF);
+        }
+        static void ClearPending(uint32_t const mask) noexcept { SR::REG.Write(~mask); }
+    };
+
+    template <peripheral tPERIPH, channel tCHAN>
+    class channel_kernel {
+        using CCMR = channel_registers<tPERIPH, tCHAN>::ccmr;
+        using CCER = channel_registers<tPERIPH, tCHAN>::ccer;
+        using CCR = channel_registers<tPERIPH, tCHAN>::ccr;
+        using DIER = channel_registers<tPERIPH, tCHAN>::dier;
+        using SR = channel_registers<tPERIPH, tCHAN>::sr;
+        using EGR = channel_registers<tPERIPH, tCHAN>::egr;
+
+        static constexpr uint32_t CCIF_MASK = TIM_SR_CC1IF << EnumValue(tCHAN);
+
+    public:
+        static void SetProperty(compare_mode const mode) noexcept { CCMR::OCM.Write(EnumValue(mode)); }
+        static void SetProperty(capture_select const select) noexcept { CCMR::CCS.Write(EnumValue(select)); }
+        static void SetProperty(polarity const polarity) noexcept { CCER::CCP.Write(EnumValue(polarity)); }
+        static void Configure(cValidChannelProperty auto... property) noexcept { ( SetProperty(property), ... ); }
+        static void OutputState(state const state) noexcept { CCER::CCE.Write(state); }
+        static void Compare(uint16_t const value) noexcept { CCR::CCR.Write(value); }
+        [[nodiscard]] static uint16_t Compare() noexcept { return CCR::CCR.Read(); }
+        static void InterruptState(state const state) noexcept { DIER::CCIE.Write(state); }
+        [[nodiscard]] static state InterruptState() noexcept { return static_cast<state>(DIER::CCIE.Read()); }
+        static void DMA(state const state) noexcept { DIER::CCDE.Write(state); }
+        [[nodiscard]] static state FlagState() noexcept { return static_cast<state>(SR::CCIF.Read()); }
+        static void ClearFlag() noexcept { SR::REG.Write(~CCIF_MASK); }
+        static void GenerateEvent() noexcept { EGR::REG.Write(CCIF_MASK); }
+        static constexpr uint32_t CompareRegisterAddress() noexcept { return CCR::REG.Address; }
+    };
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "stm32f103xb.h"
+
+#include "../utils/hardware_register.hpp"
+
+namespace hal::tim {
+
+    enum class peripheral :uint8_t {
+         TIM_1
+        ,TIM_2
+        ,TIM_3
+        ,TIM_4
+    };
+    enum class channel :uint8_t {
+         _1 = 0
+        ,_2
+        ,_3
+        ,_4
+    };
+
+    namespace details {
+        template <peripheral tPERIPH>
+        static constexpr auto TIM_BASE = []() consteval noexcept {
+            switch (tPERIPH) {
+            case peripheral::TIM_1: return TIM1_BASE;
+            case peripheral::TIM_2: return TIM2_BASE;
+            case peripheral::TIM_3: return TIM3_BASE;
+            case peripheral::TIM_4: return TIM4_BASE;
+            }
+        }();
+    }
+
+    template <peripheral tPERIPH>
+    struct registers {
+        // Control Register 1
+        struct cr1 {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, CR1)>{};
+
+            static constexpr auto CEN = REG.template CreateBitfield<TIM_CR1_CEN>();
+            static constexpr auto UDIS = REG.template CreateBitfield<TIM_CR1_UDIS>();
+            static constexpr auto URS = REG.template CreateBitfield<TIM_CR1_URS>();
+            static constexpr auto OPM = REG.template CreateBitfield<TIM_CR1_OPM>();
+            static constexpr auto DIR = REG.template CreateBitfield<TIM_CR1_DIR>();
+            static constexpr auto CMS = REG.template CreateBitfield<TIM_CR1_CMS>();
+            static constexpr auto ARPE = REG.template CreateBitfield<TIM_CR1_ARPE>();
+            static constexpr auto CKD = REG.template CreateBitfield<TIM_CR1_CKD>();
+        };
+
+        // Control Register 2
+        struct cr2 {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, CR2)>{};
+
+            static constexpr auto CCDS = REG.template CreateBitfield<TIM_CR2_CCDS>();
+            static constexpr auto MMS = REG.template CreateBitfield<TIM_CR2_MMS>();
+            static constexpr auto TI1S = REG.template CreateBitfield<TIM_CR2_TI1S>();
+        };
+
+        // Slave Mode Control Register
+        struct smcr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, SMCR)>{};
+
+            static constexpr auto SMS = REG.template CreateBitfield<TIM_SMCR_SMS>();
+            static constexpr auto TS = REG.template CreateBitfield<TIM_SMCR_TS>();
+            static constexpr auto MSM = REG.template CreateBitfield<TIM_SMCR_MSM>();
+        };
+
+        // DMA/Interrupt Enable Register
+        struct dier {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, DIER)>{};
+
+            static constexpr auto UIE = REG.template CreateBitfield<TIM_DIER_UIE>();
+            static constexpr auto TIE = REG.template CreateBitfield<TIM_DIER_TIE>();
+            static constexpr auto UDE = REG.template CreateBitfield<TIM_DIER_UDE>();
+            static constexpr auto TDE = REG.template CreateBitfield<TIM_DIER_TDE>();
+        };
+
+        // Status Register (rc_w0)
+        struct sr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, SR)>{};
+
+            static constexpr auto UIF = REG.template CreateBitfield<TIM_SR_UIF>();
+            static constexpr auto TIF = REG.template CreateBitfield<TIM_SR_TIF>();
+        };
+
+        // Event Generation Register
+        struct egr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, EGR)>{};
+
+            static constexpr auto UG = REG.template CreateBitfield<TIM_EGR_UG>();
+            static constexpr auto TG = REG.template CreateBitfield<TIM_EGR_TG>();
+        };
+
+        // Counter Register
+        struct cnt {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, CNT)>{};
+
+            static constexpr auto CNT = REG.template CreateBitfield<TIM_CNT_CNT>();
+        };
+
+        // Prescaler Register
+        struct psc {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, PSC)>{};
+
+            static constexpr auto PSC = REG.template CreateBitfield<TIM_PSC_PSC>();
+        };
+
+        // Auto-Reload Register
+        struct arr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, ARR)>{};
+
+            static constexpr auto ARR = REG.template CreateBitfield<TIM_ARR_ARR>();
+        };
+
+        // Break and Dead-Time Register (TIM1 only)
+        struct bdtr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, BDTR)>{};
+
+            static constexpr auto MOE = REG.template CreateBitfield<TIM_BDTR_MOE>();
+        };
+    };
+
+    template <peripheral tPERIPH, channel tCHAN>
+    class channel_registers {
+        static constexpr uint8_t CHANNEL = EnumValue(tCHAN);
+        static constexpr uint8_t CCMR_SHIFT = (CHANNEL % 2u) * 8u;
+        static constexpr uint8_t CCER_SHIFT = CHANNEL * 4u;
+        static constexpr uint32_t CCMR_BASE = (CHANNEL < 2u ? offsetof(TIM_TypeDef, CCMR1) : offsetof(TIM_TypeDef, CCMR2));
+        static constexpr uint32_t CCR_BASE = offsetof(TIM_TypeDef, CCR1) + (CHANNEL * 4u);
+
+    public:
+        // Capture/Compare Mode Register (CCMR1, CCMR2)
+        struct ccmr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + CCMR_BASE>{};
+
+            static constexpr auto CCS = REG.template CreateBitfield<(TIM_CCMR1_CC1S << CCMR_SHIFT)>();
+            static constexpr auto OCFE = REG.template CreateBitfield<(TIM_CCMR1_OC1FE << CCMR_SHIFT)>();
+            static constexpr auto OCPE = REG.template CreateBitfield<(TIM_CCMR1_OC1PE << CCMR_SHIFT)>();
+            static constexpr auto OCM = REG.template CreateBitfield<(TIM_CCMR1_OC1M << CCMR_SHIFT)>();
+            static constexpr auto ICPSC = REG.template CreateBitfield<(TIM_CCMR1_IC1PSC << CCMR_SHIFT)>();
+            static constexpr auto ICF = REG.template CreateBitfield<(TIM_CCMR1_IC1F << CCMR_SHIFT)>();
+        };
+        // Capture/Compare Enable Register (CCER)
+        struct ccer {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, CCER)>{};
+
+            static constexpr auto CCE = REG.template CreateBitfield<(TIM_CCER_CC1E << CCER_SHIFT)>();
+            static constexpr auto CCP = REG.template CreateBitfield<(TIM_CCER_CC1P << CCER_SHIFT)>();
+        };
+        // Capture/Compare Register (CCRx)
+        struct ccr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + CCR_BASE>{};
+
+            static constexpr auto CCR = REG.template CreateBitfield<TIM_CCR1_CCR1>();
+        };
+        // Channel bits of DIER, SR and EGR
+        struct dier {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, DIER)>{};
+
+            static constexpr auto CCIE = REG.template CreateBitfield<(TIM_DIER_CC1IE << CHANNEL)>();
+            static constexpr auto CCDE = REG.template CreateBitfield<(TIM_DIER_CC1DE << CHANNEL)>();
+        };
+        struct sr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, SR)>{};
+
+            static constexpr auto CCIF = REG.template CreateBitfield<(TIM_SR_CC1IF << CHANNEL)>();
+            static constexpr auto CCOF = REG.template CreateBitfield<(TIM_SR_CC1OF << CHANNEL)>();
+        };
+        struct egr {
+            static constexpr auto REG = hardware_register<details::TIM_BASE<tPERIPH> + offsetof(TIM_TypeDef, EGR)>{};
+
+            static constexpr auto CCG = REG.template CreateBitfield<(TIM_EGR_CC1G << CHANNEL)>();
+        };
+    };
+}
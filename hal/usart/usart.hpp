@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <span>
@@ -9,6 +10,7 @@
 #include "include/expected.hpp"
 
 #include "utils/utility.hpp"
+#include "system/clock.hpp"
 #include "system/tick.hpp"
 #include "system/interrupt.hpp"
 
@@ -121,6 +123,8 @@ namespace hal::usart {
         transfer_speed const Baud;
         size_t const RxBufferSize = 64;
         size_t const TxBufferSize = 64;
+        // Stops the peripheral clock whenever no transfer is in flight (rcc::clock_handler)
+        bool const ClockGating = false;
     };
 
     ////////////////////////////////
@@ -134,12 +138,15 @@ namespace hal::usart {
         using kernel = usart::kernel<tSPEC.Peripheral>;
         using irq = system::interrupt<details::IRQ<tSPEC.Peripheral>>;
         using pclk = rcc::clock_handler<details::PCLK<tSPEC.Peripheral>>;
+        using activity = rcc::clock_activity<details::PCLK<tSPEC.Peripheral>, tSPEC.ClockGating>;
         using tx_pin = gpio::module<details::TxPinSpec<tSPEC.Peripheral>>;
         using rx_pin = gpio::module<details::RxPinSpec<tSPEC.Peripheral>>;
         using rx_dma = dma::module<details::RxDMA_Spec<tSPEC.Peripheral>>;
         using tx_dma = dma::module<details::TxDMA_Spec<tSPEC.Peripheral>>;
 
     public:
+        static constexpr std::array DmaChannels{ details::TxDMA_Channel<tSPEC.Peripheral>, details::RxDMA_Channel<tSPEC.Peripheral> };
+
         using data_type = std::conditional_t<tSPEC.DataWidth == data_width::_8bits, uint8_t, uint16_t>;
         using rx_fifo = fifo_buffer<data_type, tSPEC.RxBufferSize>;
         using tx_fifo = fifo_buffer<data_type, tSPEC.TxBufferSize>;
@@ -184,15 +191,21 @@ namespace hal::usart {
 
             kernel::Configure(tSPEC.DataWidth, tSPEC.ParityBit, tSPEC.StopBits, tSPEC.FlowControl, tSPEC.Baud);
             kernel::State(ENABLED);
+            clock_idle();
+        }
+        ~module() noexcept
+        {
+            clock_busy();
+            kernel::State(DISABLED);
         }
-        ~module() noexcept { kernel::State(DISABLED); }
 
         expected<size_t, error_code> Transmit(data_type const value) noexcept
         {
+            activity const busy;
             kernel::TxState(ENABLED);
-            while (not kernel::template Flag<flag::TXE>());
+            while (not kernel::template FlagState<flag::TXE>());
             kernel::WriteData(value);
-            while (not kernel::template Flag<flag::TC>());
+            while (not kernel::template FlagState<flag::TC>());
             kernel::TxState(DISABLED);
             return 1u;
         }
@@ -201,16 +214,18 @@ namespace hal::usart {
             if (TxBuffer.empty()) [[unlikely]]
                 return MakeUnexpected(error_code::TxBufferEmpty);
             
+            activity const busy;
             size_t pos;
+            size_t const count = TxBuffer.size();
             system::timer watchdog(constants::Timeout, true);
             kernel::TxState(ENABLED);
-            for (pos = 0; pos < TxBuffer.size(); ++pos) {
+            for (pos = 0; pos < count; ++pos) {
                 if (not wait_for_flag_state<flag::TXE>(ENABLED, watchdog)) {
                     kernel::TxState(DISABLED);
                     return MakeUnexpected(error_code::TimedOut);
                 }
                 if (auto const res{ TxBuffer.pop() }; res.has_value()) {
-                    kernel::WriteData(res);
+                    kernel::WriteData(*res);
                 }
                 else {
                     return MakeUnexpected(error_code::TxBufferEmpty);
@@ -223,6 +238,7 @@ namespace hal::usart {
 
         size_t Receive(data_type& rx_data) noexcept
         {
+            activity const busy;
             kernel::RxState(ENABLED);
             while (not kernel::template FlagState<flag::RXNE>());
             rx_data = kernel::ReadData();
@@ -231,6 +247,7 @@ namespace hal::usart {
         }
         size_t Receive(size_t const nbytes) noexcept
         {
+            activity const busy;
             kernel::RxState(ENABLED);
             for (size_t i = 0; i < nbytes; ++i) {
                 if (not wait_for_flag_state<flag::RXNE>(ENABLED)) {
@@ -251,23 +268,25 @@ namespace hal::usart {
             if (TxBuffer.empty()) [[unlikely]]
                 return status::Error;
 
+            clock_busy();
             kernel::TxState(ENABLED);
             if (not wait_for_flag_state<flag::TXE>(ENABLED)) {
                 kernel::TxState(DISABLED);
+                clock_idle();
                 return status::TimedOut;
             }
             if (auto const res{ TxBuffer.pop() }; res.has_value()) {
                 kernel::WriteData(*res);
-                if (not TxBuffer.empty()) {
-                    mTxBusy = true;
+                // Busy until TC, so a single-frame transfer also completes in the ISR
+                mTxBusy = true;
+                if (not TxBuffer.empty())
                     kernel::template InterruptState<interrupt::TXE>(ENABLED);
-                }
-                else {
+                else
                     kernel::template InterruptState<interrupt::TC>(ENABLED);
-                }
                 return status::OK;
             }
             kernel::TxState(DISABLED);
+            clock_idle();
             return status::Error;
         }
         template <transfer_mode tXFER>
@@ -280,6 +299,7 @@ namespace hal::usart {
                 return status::Error;
 
             mTxBusyDMA = true;
+            clock_busy();
             kernel::TxState(ENABLED);
             mTxDMA.Start(reinterpret_cast<uintptr_t>(TxBuffer.data()), kernel::DataRegisterAddress(), TxBuffer.size());
             kernel::template ClearFlag<flag::TC>();
@@ -295,6 +315,7 @@ namespace hal::usart {
                 return status::Busy;
 
             mRxBusy = true;
+            clock_busy();
             RxBuffer.clear();
             kernel::template InterruptState<interrupt::IDLE>(ENABLED);
             kernel::template InterruptState<interrupt::RXNE>(ENABLED);
@@ -308,7 +329,9 @@ namespace hal::usart {
             if (mRxBusy or mRxBusyDMA) [[unlikely]]
                 return status::Busy;
 
+            // Circular reception keeps the clock running from here on
             mRxBusyDMA = true;
+            clock_busy();
             kernel::RxState(ENABLED);
             mRxDMA.Start(kernel::DataRegisterAddress(), reinterpret_cast<uintptr_t>(mRxDMA_Buffer), tSPEC.RxBufferSize);
             kernel::template ClearFlag<flag::ORE>();
@@ -317,8 +340,16 @@ namespace hal::usart {
             return status::OK;
         }
 
+        // Recomputes BRR for the new bus clock; call between frames (system::clock_listener)
+        void Retime(system::clock_frequencies const& clocks) noexcept
+        {
+            activity const busy;
+            uint32_t const pclk = (tSPEC.Peripheral == peripheral::USART_1) ? clocks.PCLK2 : clocks.PCLK1;
+            kernel::SetProperty(transfer_speed{ tSPEC.Baud.Baudrate, pclk });
+        }
+
     private:
-        INLINE void isr() noexcept
+        RAMFUNC void isr() noexcept
         {
             if (kernel::template FlagState<flag::RXNE>()
                 and kernel::template InterruptState<interrupt::RXNE>()
@@ -338,6 +369,7 @@ namespace hal::usart {
                     kernel::template InterruptState<interrupt::IDLE>(DISABLED);
                     kernel::template InterruptState<interrupt::RXNE>(DISABLED);
                     mRxBusy = false;
+                    clock_idle();
                 }
                 else {
                     uint16_t curr_pos = tSPEC.RxBufferSize - mRxDMA.DataCounter();
@@ -382,6 +414,7 @@ namespace hal::usart {
                     kernel::TxState(DISABLED);
                     kernel::template InterruptState<interrupt::TXE>(DISABLED);
                     mTxBusy = false;
+                    clock_idle();
                 }
             }
             else if (kernel::template FlagState<flag::TC>()
@@ -392,9 +425,20 @@ namespace hal::usart {
                 kernel::template InterruptState<interrupt::TC>(DISABLED);
                 mTxBusy = false;
                 mTxBusyDMA = false;
+                clock_idle();
                 TxComplete();
             }
         }
+        INLINE static void clock_busy() noexcept
+        {
+            if constexpr (tSPEC.ClockGating)
+                pclk::Acquire();
+        }
+        INLINE static void clock_idle() noexcept
+        {
+            if constexpr (tSPEC.ClockGating)
+                pclk::Release();
+        }
         template <flag tFLAG>
         INLINE bool wait_for_flag_state(state const state, system::timer const& watch_dog = {constants::Timeout, true}) noexcept
         {
@@ -68,6 +68,8 @@ namespace hal::usart {
             ,_115200 = 115200
             ,_230400 = 230400
             ,_250000 = 250000
+            ,_500000 = 500000
+            ,_1000000 = 1000000
         } Baudrate;
         uint32_t const PCLK_Frequency;
     };
@@ -118,12 +120,10 @@ namespace hal::usart {
         }
         static void SetProperty(transfer_speed const& baudrate) noexcept
         {
-            uint32_t const div_x100 = (baudrate.PCLK_Frequency * 25u) / (baudrate.Baudrate * 4u);
-            uint32_t const mant = div_x100 / 100u;
-            uint32_t const frac = (((div_x100 - (mant * 100u)) * 16u) + 50u) / 100u;
-
-            BRR::MANTISSA.Write(mant & 0xFFF);
-            BRR::FRACTION.Write(frac & 0xF);
+            // BRR holds USARTDIV in 12.4 fixed point, i.e. PCLK / baudrate; rounding the whole value
+            // lets a fraction that rounds up to 16 carry into the mantissa
+            uint32_t const brr = (baudrate.PCLK_Frequency + (baudrate.Baudrate / 2u)) / baudrate.Baudrate;
+            BRR::REG.Write(brr & (USART_BRR_DIV_Mantissa | USART_BRR_DIV_Fraction));
         }
         static void Configure(cValidProperty auto... property) noexcept { ( SetProperty(property), ... ); }
         template <interrupt tInterrupt>
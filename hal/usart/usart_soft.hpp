@@ -0,0 +1,251 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include "include/fifo_buffer.hpp"
+#include "include/expected.hpp"
+
+#include "utils/utility.hpp"
+#include "system/tick.hpp"
+
+#include "gpio/gpio.hpp"
+#include "tim/tim.hpp"
+#include "usart_kernel.hpp"
+
+namespace hal::usart {
+
+    ////////////////////////////////
+    // Specification
+    ////////////////////////////////
+    // Baud.PCLK_Frequency is the timer kernel clock (twice PCLK1 when the APB1 prescaler is not 1).
+    struct soft_specification {
+        tim::peripheral const Timer;
+        gpio::port const TxPort;
+        gpio::pin const TxPin;
+        gpio::port const RxPort;
+        gpio::pin const RxPin;
+        data_width const DataWidth = data_width::_8bits;
+        parity_bit const ParityBit = parity_bit::None;
+        stop_bits const StopBits = stop_bits::_1;
+        transfer_speed const Baud;
+        size_t const RxBufferSize = 64;
+        size_t const TxBufferSize = 64;
+        uint8_t const Priority = 0;
+    };
+
+    ////////////////////////////////
+    // Soft Module
+    ////////////////////////////////
+    // Bit-banged USART on any pair of GPIO pins. Each instance owns one general purpose timer:
+    // channel 1 clocks the transmitter, channel 2 samples the receiver after the EXTI start-bit edge.
+    template <soft_specification tSPEC>
+    class soft_module {
+        static_assert(tSPEC.StopBits == stop_bits::_1 or tSPEC.StopBits == stop_bits::_2, "Soft USART supports 1 or 2 stop bits");
+
+        static constexpr uint16_t BIT_TICKS = tSPEC.Baud.PCLK_Frequency / tSPEC.Baud.Baudrate;
+        static_assert(BIT_TICKS >= 64u and BIT_TICKS <= (0xFFFFu * 2u) / 3u, "Baudrate out of range for timer clock");
+
+        static constexpr uint8_t DATA_BITS = (tSPEC.DataWidth == data_width::_8bits) ? 8u : 9u;
+        static constexpr uint8_t PARITY_BITS = (tSPEC.ParityBit == parity_bit::None) ? 0u : 1u;
+        static constexpr uint8_t STOP_BITS = (tSPEC.StopBits == stop_bits::_1) ? 1u : 2u;
+        static constexpr uint8_t FRAME_BITS = 1u + DATA_BITS + PARITY_BITS + STOP_BITS;
+        static constexpr uint8_t PAYLOAD_BITS = DATA_BITS + PARITY_BITS;
+        static constexpr uint16_t DATA_MASK = (1u << DATA_BITS) - 1u;
+
+        static constexpr auto TimerSpec = tim::specification {
+            .Peripheral = tSPEC.Timer,
+            .Priority = tSPEC.Priority
+        };
+        static constexpr auto TxPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = tSPEC.TxPort,
+            .Pin = tSPEC.TxPin,
+            .OutputMode = gpio::output_mode::GP_PushPull,
+            .OutputSpeed = gpio::output_speed::_10MHz
+        };
+        static constexpr auto RxPinSpec = gpio::specification<gpio::pin_type::ExtInterrupt> {
+            .Port = tSPEC.RxPort,
+            .Pin = tSPEC.RxPin,
+            .InputMode = gpio::input_mode::PullUp
+        };
+
+        using timer = tim::module<TimerSpec>;
+        using tx_pin = gpio::module<TxPinSpec>;
+        using rx_pin = gpio::module<RxPinSpec>;
+
+    public:
+        using data_type = std::conditional_t<tSPEC.DataWidth == data_width::_8bits, uint8_t, uint16_t>;
+        using rx_fifo = fifo_buffer<data_type, tSPEC.RxBufferSize>;
+        using tx_fifo = fifo_buffer<data_type, tSPEC.TxBufferSize>;
+
+        enum class error_code :uint8_t {
+             None
+            ,TimedOut
+            ,TxBufferEmpty
+            ,TxBufferFull
+        };
+
+    public:
+        tx_fifo TxBuffer;
+        rx_fifo RxBuffer;
+
+        callback TxComplete;
+        delegate<void(data_type const)> RxStream;
+
+    public:
+        soft_module() noexcept
+            : mTimer()
+            , mTxPin(gpio::pin_state::High)
+            , mRxPin(exti::mode::Off, exti::trigger::Falling, callback::template Create<soft_module, &soft_module::start_bit>(*this))
+        {
+            mTimer.CaptureCompare[0].template Set<soft_module, &soft_module::tx_bit>(*this);
+            mTimer.CaptureCompare[1].template Set<soft_module, &soft_module::rx_bit>(*this);
+            mTimer.Start();
+        }
+        ~soft_module() noexcept
+        {
+            StopReceiving();
+            mTimer.template ChannelInterrupt<tim::channel::_1>(DISABLED);
+        }
+
+        expected<size_t, error_code> Transmit(data_type const value) noexcept
+        {
+            if (not TxBuffer.push(value)) [[unlikely]]
+                return MakeUnexpected(error_code::TxBufferFull);
+
+            return Transmit();
+        }
+        expected<size_t, error_code> Transmit() noexcept
+        {
+            if (TxBuffer.empty() and not mTxBusy) [[unlikely]]
+                return MakeUnexpected(error_code::TxBufferEmpty);
+
+            size_t const count = TxBuffer.size();
+            system::timer watchdog(constants::Timeout, true);
+            StartTransmitting();
+            while (mTxBusy) {
+                if (watchdog.IsExpired())
+                    return MakeUnexpected(error_code::TimedOut);
+            }
+            return count;
+        }
+        status StartTransmitting() noexcept
+        {
+            if (mTxBusy) [[unlikely]]
+                return status::Busy;
+            if (TxBuffer.empty()) [[unlikely]]
+                return status::Error;
+
+            mTxBusy = true;
+            mTxBits = 0;
+            mTimer.template Compare<tim::channel::_1>(mTimer.Counter() + BIT_TICKS);
+            mTimer.template ChannelInterrupt<tim::channel::_1>(ENABLED);
+            return status::OK;
+        }
+        status StartReceiving() noexcept
+        {
+            if (mRxBusy) [[unlikely]]
+                return status::Busy;
+
+            mRxBusy = true;
+            arm_start_bit();
+            return status::OK;
+        }
+        void StopReceiving() noexcept
+        {
+            mRxPin.SetMode(exti::mode::Off);
+            mTimer.template ChannelInterrupt<tim::channel::_2>(DISABLED);
+            mRxBusy = false;
+        }
+        [[nodiscard]] bool IsTransmitting() const noexcept { return mTxBusy; }
+        [[nodiscard]] uint16_t FrameErrors() const noexcept { return mFrameErrors; }
+
+    private:
+        static constexpr uint16_t make_frame(data_type const value) noexcept
+        {
+            uint16_t frame = value & DATA_MASK;
+            if constexpr (PARITY_BITS)
+                frame |= static_cast<uint16_t>((~std::popcount(frame)) & 1u) << DATA_BITS;
+
+            frame |= ((1u << STOP_BITS) - 1u) << PAYLOAD_BITS;
+            return frame << 1u;
+        }
+        static constexpr bool parity_ok(uint16_t const payload) noexcept
+        {
+            if constexpr (PARITY_BITS)
+                return (std::popcount(payload) & 1u) == 1u;
+            else
+                return true;
+        }
+        INLINE void arm_start_bit() noexcept
+        {
+            mRxPin.ClearPending();
+            mRxPin.SetMode(exti::mode::Interrupt);
+        }
+        void start_bit() noexcept
+        {
+            mRxPin.SetMode(exti::mode::Off);
+            mRxPin.ClearPending();
+            // First sample lands in the middle of data bit 0
+            mTimer.template Compare<tim::channel::_2>(mTimer.Counter() + BIT_TICKS + (BIT_TICKS / 2u));
+            mTimer.template ChannelInterrupt<tim::channel::_2>(ENABLED);
+            mRxShift = 0;
+            mRxBits = 0;
+        }
+        void rx_bit() noexcept
+        {
+            bool const level = mRxPin;
+            mTimer.template Compare<tim::channel::_2>(mTimer.template Compare<tim::channel::_2>() + BIT_TICKS);
+
+            if (mRxBits < PAYLOAD_BITS) {
+                mRxShift |= static_cast<uint16_t>(level) << mRxBits;
+                ++mRxBits;
+                return;
+            }
+            mTimer.template ChannelInterrupt<tim::channel::_2>(DISABLED);
+            if (level and parity_ok(mRxShift)) {
+                auto const rx = static_cast<data_type>(mRxShift & DATA_MASK);
+                if (not RxStream.CallIf(rx))
+                    RxBuffer.push(rx);
+            }
+            else {
+                mFrameErrors = mFrameErrors + 1u;
+            }
+            if (mRxBusy)
+                arm_start_bit();
+        }
+        void tx_bit() noexcept
+        {
+            mTimer.template Compare<tim::channel::_1>(mTimer.template Compare<tim::channel::_1>() + BIT_TICKS);
+
+            if (not mTxBits) {
+                auto const res{ TxBuffer.pop() };
+                if (not res.has_value()) {
+                    mTimer.template ChannelInterrupt<tim::channel::_1>(DISABLED);
+                    mTxBusy = false;
+                    TxComplete();
+                    return;
+                }
+                mTxFrame = make_frame(*res);
+                mTxBits = FRAME_BITS;
+            }
+            (mTxFrame & 1u) ? mTxPin.SetPin() : mTxPin.ResetPin();
+            mTxFrame >>= 1u;
+            --mTxBits;
+        }
+
+    private:
+        timer mTimer;
+        tx_pin mTxPin;
+        rx_pin mRxPin;
+
+        bool volatile mTxBusy = false;
+        bool volatile mRxBusy = false;
+        uint8_t mTxBits = 0;
+        uint8_t mRxBits = 0;
+        uint16_t mTxFrame = 0;
+        uint16_t mRxShift = 0;
+        uint16_t volatile mFrameErrors = 0;
+    };
+} // namespace hal::usart
@@ -7,6 +7,17 @@
 
 #define INLINE inline __attribute__((always_inline))
 
+// Runs the function from SRAM (.ramfunc, copied by the startup code), clear of flash wait states
+// and prefetch misses. Define HAL_NO_RAMFUNC to keep everything in flash, e.g. to compare cycle
+// counts with system::cycle_counter (benchmarks/isr_ramfunc.cpp builds both ways).
+#if defined(HAL_NO_RAMFUNC)
+    #define RAMFUNC __attribute__((noinline))
+#elif defined(__arm__)
+    #define RAMFUNC __attribute__((section(".ramfunc"), noinline, long_call))
+#else
+    #define RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#endif
+
 #ifndef NVIC_PRIORITYGROUP_0
     #define NVIC_PRIORITYGROUP_0    ((uint32_t)0x00000007)     /*!< 0 bit  for pre-emption priority, 4 bits for subpriority */
     #define NVIC_PRIORITYGROUP_1    ((uint32_t)0x00000006)     /*!< 1 bit  for pre-emption priority, 3 bits for subpriority */
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+
+#include "utils/utility.hpp"
+#include "system/tick.hpp"
+
+#include "gpio/gpio.hpp"
+#include "spi/spi.hpp"
+#include "tim/tim.hpp"
+
+namespace hal::w25q {
+
+    static constexpr uint16_t PageSize = 256;
+    static constexpr uint16_t SectorSize = 4096;
+
+    ////////////////////////////////
+    // Specification
+    ////////////////////////////////
+    // The timer polls BUSY every (PollPrescaler + 1) * (PollPeriod + 1) timer clocks while a
+    // program or erase is pending; 100 us at 72 MHz by default.
+    struct specification {
+        gpio::port const SelectPort;
+        gpio::pin const SelectPin;
+        tim::peripheral const Timer;
+        uint16_t const PollPrescaler = 71;
+        uint16_t const PollPeriod = 99;
+        uint16_t const CacheLineSize = PageSize;
+        uint8_t const CacheLines = 4;
+        uint8_t const WriteQueueSize = 4;
+    };
+
+    ////////////////////////////////
+    // Memory
+    ////////////////////////////////
+    // W25Qxx NOR flash on an 8-bit TxRx spi::module with DmaTransfers. Reads stream with FAST_READ
+    // over DMA through a small write-through LRU cache; page programs and sector erases are queued
+    // and issued from the poll timer ISR, which owns the bus until the queue drains. The SPI
+    // TransferComplete handler installed before construction keeps receiving the transfers that
+    // are not page programs.
+    template <typename tSPI, specification tSPEC>
+    requires std::same_as<typename tSPI::data_type, uint8_t>
+    class memory {
+        static_assert(tSPEC.CacheLineSize >= 16 and tSPEC.CacheLineSize <= SectorSize
+            and (tSPEC.CacheLineSize & (tSPEC.CacheLineSize - 1)) == 0, "Cache line size must be a power of two up to one sector");
+        // One slot always stays empty to tell a full queue from an empty one
+        static_assert(tSPEC.WriteQueueSize >= 2 and (tSPEC.WriteQueueSize & (tSPEC.WriteQueueSize - 1)) == 0, "Write queue size must be a power of two of at least 2");
+
+        static constexpr auto SelectPinSpec = gpio::specification<gpio::pin_type::Output> {
+            .Port = tSPEC.SelectPort,
+            .Pin = tSPEC.SelectPin,
+            .OutputMode = gpio::output_mode::GP_PushPull,
+            .OutputSpeed = gpio::output_speed::_50MHz
+        };
+        static constexpr auto TimerSpec = tim::specification {
+            .Peripheral = tSPEC.Timer,
+            .Prescaler = tSPEC.PollPrescaler,
+            .Period = tSPEC.PollPeriod
+        };
+        using select_pin = gpio::module<SelectPinSpec>;
+        using timer = tim::module<TimerSpec>;
+
+        enum instruction :uint8_t {
+             WRITE_ENABLE = 0x06
+            ,READ_STATUS_1 = 0x05
+            ,PAGE_PROGRAM = 0x02
+            ,SECTOR_ERASE = 0x20
+            ,FAST_READ = 0x0B
+            ,JEDEC_ID = 0x9F
+        };
+        static constexpr uint8_t STATUS_BUSY = 0x01;
+        static constexpr uint32_t LINE_MASK = ~static_cast<uint32_t>(tSPEC.CacheLineSize - 1u);
+        static constexpr uint32_t QUEUE_MASK = tSPEC.WriteQueueSize - 1u;
+
+        enum class operation :uint8_t {
+             Program
+            ,Erase
+        };
+        struct job {
+            operation Operation;
+            uint16_t Size;
+            uint32_t Address;
+            uint8_t Data[PageSize];
+        };
+        struct cache_line {
+            uint32_t Address;
+            uint32_t LastUse;
+            bool Valid;
+        };
+
+    public:
+        explicit memory(tSPI& spi) noexcept
+            : mSPI(spi)
+            , mSelect(gpio::pin_state::High)
+            , mChained(spi.TransferComplete)
+        {
+            mSPI.TransferComplete.template Set<memory, &memory::program_sent>(*this);
+            mTimer.Update.template Set<memory, &memory::poll>(*this);
+            mTimer.Start();
+        }
+        ~memory() noexcept
+        {
+            (void)Flush();
+            mSPI.TransferComplete = mChained;
+        }
+
+        [[nodiscard]] uint32_t Identify() noexcept
+        {
+            if (Flush() != status::OK)
+                return 0;
+
+            select();
+            (void)exchange(JEDEC_ID);
+            uint32_t id = exchange(0xFF);
+            id = (id << 8) | exchange(0xFF);
+            id = (id << 8) | exchange(0xFF);
+            deselect();
+            return id;
+        }
+
+        // Reads of at least one cache line stream straight into data; smaller reads go through the cache.
+        status Read(uint32_t address, uint8_t* data, size_t size) noexcept
+        {
+            if (size >= tSPEC.CacheLineSize) {
+                if (Flush() != status::OK)
+                    return status::TimedOut;
+                return fast_read(address, data, size);
+            }
+            while (size) {
+                uint32_t const offset = address & ~LINE_MASK;
+                size_t const chunk = std::min<size_t>(size, tSPEC.CacheLineSize - offset);
+
+                uint8_t const* line = lookup(address & LINE_MASK);
+                if (line == nullptr)
+                    return status::Error;
+
+                std::memcpy(data, line + offset, chunk);
+                address += chunk;
+                data += chunk;
+                size -= chunk;
+            }
+            return status::OK;
+        }
+        // Queues page programs; returns once the data is copied, before the flash is written.
+        status Program(uint32_t address, uint8_t const* data, size_t size) noexcept
+        {
+            while (size) {
+                size_t const chunk = std::min<size_t>(size, PageSize - (address & (PageSize - 1u)));
+                job* const slot = reserve();
+                if (slot == nullptr)
+                    return status::TimedOut;
+
+                slot->Operation = operation::Program;
+                slot->Address = address;
+                slot->Size = static_cast<uint16_t>(chunk);
+                std::memcpy(slot->Data, data, chunk);
+                update_cache(address, data, chunk);
+                commit();
+
+                address += chunk;
+                data += chunk;
+                size -= chunk;
+            }
+            return status::OK;
+        }
+        status EraseSector(uint32_t const address) noexcept
+        {
+            job* const slot = reserve();
+            if (slot == nullptr)
+                return status::TimedOut;
+
+            slot->Operation = operation::Erase;
+            slot->Address = address & ~static_cast<uint32_t>(SectorSize - 1u);
+            slot->Size = 0;
+            erase_cache(slot->Address);
+            commit();
+            return status::OK;
+        }
+        // Waits until every queued program and erase has completed.
+        status Flush(uint32_t const timeout = constants::Timeout) noexcept
+        {
+            system::timer watchdog(timeout, true);
+            while (IsBusy()) {
+                if (watchdog.IsExpired())
+                    return status::TimedOut;
+            }
+            return status::OK;
+        }
+        [[nodiscard]] bool IsBusy() const noexcept { return mHead != mTail or mInFlight; }
+
+    private:
+        uint8_t exchange(uint8_t value) noexcept
+        {
+            uint8_t rx = 0xFF;
+            (void)mSPI.template Transfer<tSPI::BLOCKING>(&value, &rx, 1);
+            return rx;
+        }
+        INLINE void select() noexcept { mSelect.ResetPin(); }
+        INLINE void deselect() noexcept { mSelect.SetPin(); }
+        void send_address(uint8_t const instruction, uint32_t const address) noexcept
+        {
+            (void)exchange(instruction);
+            (void)exchange(static_cast<uint8_t>(address >> 16));
+            (void)exchange(static_cast<uint8_t>(address >> 8));
+            (void)exchange(static_cast<uint8_t>(address));
+        }
+        status fast_read(uint32_t const address, uint8_t* data, size_t size) noexcept
+        {
+            select();
+            send_address(FAST_READ, address);
+            (void)exchange(0xFF);
+
+            mReading = true;
+            status result = status::OK;
+            while (size and result == status::OK) {
+                uint16_t const chunk = static_cast<uint16_t>(std::min<size_t>(size, 0xFFFFu));
+                result = mSPI.template Transfer<tSPI::DMA>(nullptr, data, chunk);
+                system::timer watchdog(constants::Timeout, true);
+                while (result == status::OK and mSPI.IsBusy()) {
+                    if (watchdog.IsExpired())
+                        result = status::TimedOut;
+                }
+                data += chunk;
+                size -= chunk;
+            }
+            mReading = false;
+            deselect();
+            return result;
+        }
+
+        ////////////////////////////////
+        // Cache
+        ////////////////////////////////
+        uint8_t const* lookup(uint32_t const line_address) noexcept
+        {
+            size_t victim = 0;
+            for (size_t i = 0; i != tSPEC.CacheLines; ++i) {
+                if (mCache[i].Valid and mCache[i].Address == line_address) {
+                    mCache[i].LastUse = ++mUseCounter;
+                    return mCacheData[i];
+                }
+                if (mCache[victim].Valid and (not mCache[i].Valid or mCache[i].LastUse < mCache[victim].LastUse))
+                    victim = i;
+            }
+            if (Flush() != status::OK or fast_read(line_address, mCacheData[victim], tSPEC.CacheLineSize) != status::OK)
+                return nullptr;
+
+            mCache[victim] = { line_address, ++mUseCounter, true };
+            return mCacheData[victim];
+        }
+        void update_cache(uint32_t const address, uint8_t const* data, size_t const size) noexcept
+        {
+            // Programming can only clear bits, so cached lines track the flash contents with AND
+            for (size_t i = 0; i != tSPEC.CacheLines; ++i) {
+                if (not mCache[i].Valid)
+                    continue;
+
+                uint32_t const begin = std::max(address, mCache[i].Address);
+                uint32_t const end = std::min<uint32_t>(address + size, mCache[i].Address + tSPEC.CacheLineSize);
+                for (uint32_t a = begin; a < end; ++a)
+                    mCacheData[i][a - mCache[i].Address] &= data[a - address];
+            }
+        }
+        void erase_cache(uint32_t const sector) noexcept
+        {
+            for (size_t i = 0; i != tSPEC.CacheLines; ++i) {
+                if (mCache[i].Valid and (mCache[i].Address & ~static_cast<uint32_t>(SectorSize - 1u)) == sector)
+                    std::memset(mCacheData[i], 0xFF, tSPEC.CacheLineSize);
+            }
+        }
+
+        ////////////////////////////////
+        // Write pipeline
+        ////////////////////////////////
+        job* reserve() noexcept
+        {
+            system::timer watchdog(constants::Timeout, true);
+            while (((mHead + 1u) & QUEUE_MASK) == mTail) {
+                if (watchdog.IsExpired())
+                    return nullptr;
+            }
+            return &mQueue[mHead];
+        }
+        void commit() noexcept
+        {
+            mHead = (mHead + 1u) & QUEUE_MASK;
+            mTimer.UpdateInterrupt(ENABLED);
+        }
+        // Poll timer ISR: wait for BUSY to clear, then issue the next queued job
+        void poll() noexcept
+        {
+            if (mProgramming)
+                return;
+
+            if (mInFlight) {
+                select();
+                (void)exchange(READ_STATUS_1);
+                uint8_t const status_1 = exchange(0xFF);
+                deselect();
+                if (status_1 & STATUS_BUSY)
+                    return;
+                mTail = (mTail + 1u) & QUEUE_MASK;
+                mInFlight = false;
+            }
+            if (mHead == mTail) {
+                mTimer.UpdateInterrupt(DISABLED);
+                return;
+            }
+
+            job& next = mQueue[mTail];
+            select();
+            (void)exchange(WRITE_ENABLE);
+            deselect();
+
+            select();
+            mInFlight = true;
+            if (next.Operation == operation::Erase) {
+                send_address(SECTOR_ERASE, next.Address);
+                deselect();
+                return;
+            }
+            send_address(PAGE_PROGRAM, next.Address);
+            mProgramming = true;
+            if (mSPI.template Transfer<tSPI::DMA>(next.Data, nullptr, next.Size) != status::OK)
+                program_sent();
+        }
+        // SPI DMA completion: the page is latched, programming starts on CS rising edge
+        void program_sent() noexcept
+        {
+            if (not mProgramming) {
+                if (not mReading)
+                    mChained.CallIf();
+                return;
+            }
+
+            deselect();
+            mProgramming = false;
+        }
+
+    private:
+        tSPI& mSPI;
+        select_pin mSelect;
+        timer mTimer;
+        callback const mChained;
+
+        size_t volatile mHead = 0;
+        size_t volatile mTail = 0;
+        bool volatile mInFlight = false;
+        bool volatile mProgramming = false;
+        bool volatile mReading = false;
+        job mQueue[tSPEC.WriteQueueSize];
+
+        uint32_t mUseCounter = 0;
+        cache_line mCache[tSPEC.CacheLines]{};
+        uint8_t mCacheData[tSPEC.CacheLines][tSPEC.CacheLineSize];
+    };
+}